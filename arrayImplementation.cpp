@@ -1,324 +1,381 @@
 #include <iostream>
 #include <vector>
-#include <stdexcept>
-#include <algorithm>
+#include <string>
+#include <chrono>
+#include <iomanip>
+#include "arrayImplementation.h"
+#include "sparseSolvers.h"
 using namespace std;
 
-// SparseMatrixArray class using dynamic arrays for sparse matrix representation
-class SparseMatrixArray {
-private:
-    int rows;
-    int cols;
-    int capacity;
-    int size; // Number of non-zero elements
-    int* rowIndices;
-    int* colIndices;
-    double* values;
-    
-    // Helper function to find insertion point using binary search
-    int findInsertionPoint(int row, int col) const {
-        int left = 0;
-        int right = size;
-        
-        while (left < right) {
-            int mid = left + (right - left) / 2;
-            if (rowIndices[mid] < row || 
-                (rowIndices[mid] == row && colIndices[mid] < col)) {
-                left = mid + 1;
-            } else {
-                right = mid;
-            }
-        }
-        return left;
+// Average seconds per call of f over reps calls (after one warm-up call)
+template <typename F>
+double timePerCall(F f, int reps) {
+    f();
+    auto startTime = chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++) {
+        f();
     }
+    return chrono::duration<double>(chrono::steady_clock::now() - startTime).count() / reps;
+}
+
+// Compare SpMV kernels against a STREAM-style triad bandwidth measurement
+void runSpMVBenchmark() {
+    // Reference bandwidth: a[i] = b[i] + 3 * c[i] moves 24 bytes per element
+    const size_t N = 1 << 24;
+    vector<double> a(N, 0.0), b(N, 1.0), c(N, 2.0);
+    double triadTime = timePerCall([&]() {
+        for (size_t i = 0; i < N; i++) a[i] = b[i] + 3.0 * c[i];
+    }, 5);
+    double streamBandwidth = 24.0 * N / triadTime / 1e9;
+    a = vector<double>();
+    b = vector<double>();
+    c = vector<double>();
     
-    // Helper function to find element index using binary search
-    int findElementIndex(int row, int col) const {
-        int left = 0;
-        int right = size - 1;
-        
-        while (left <= right) {
-            int mid = left + (right - left) / 2;
-            if (rowIndices[mid] == row && colIndices[mid] == col) {
-                return mid;
-            } else if (rowIndices[mid] < row || 
-                      (rowIndices[mid] == row && colIndices[mid] < col)) {
-                left = mid + 1;
-            } else {
-                right = mid - 1;
-            }
-        }
-        return -1; // Not found
-    }
+#ifdef __AVX2__
+    const char* simd = "AVX2";
+#else
+    const char* simd = "scalar";
+#endif
+    cout << "SpMV benchmark (" << simd << " kernels, " << defaultThreadCount() 
+         << " hardware threads)" << endl;
+    cout << "Triad bandwidth: " << fixed << setprecision(2) << streamBandwidth << " GB/s" << endl;
     
-    // Resize arrays when capacity is exceeded
-    void resize() {
-        capacity *= 2;
-        int* newRowIndices = new int[capacity];
-        int* newColIndices = new int[capacity];
-        double* newValues = new double[capacity];
+    struct Case { string name; SparseMatrixArray matrix; };
+    vector<Case> cases;
+    cases.push_back({"poisson2d 1000x1000", poissonMatrix2D(1000)});
+    cases.push_back({"random 1M, 10/row", randomSparseMatrix(1000000, 1000000, 10, 1)});
+    cases.push_back({"power-law 1M, ~10/row", powerLawSparseMatrix(1000000, 10, 2)});
+    
+    for (const Case& testCase : cases) {
+        const SparseMatrixArray& matrix = testCase.matrix;
+        int rows = matrix.getDimensions().first;
+        int cols = matrix.getDimensions().second;
+        double nnz = matrix.getNonZeroCount();
         
-        for (int i = 0; i < size; i++) {
-            newRowIndices[i] = rowIndices[i];
-            newColIndices[i] = colIndices[i];
-            newValues[i] = values[i];
-        }
+        CSRMatrix csr = matrix.toCSR();
+        SellCSigmaMatrix sell(csr, 8, 256);
+        auto csrFloat = convertToCSR<BasicCSRMatrix<float, uint32_t>>(matrix);
+        vector<double> x(cols, 1.0), y(rows, 0.0);
+        vector<float> xFloat(cols, 1.0f), yFloat(rows, 0.0f);
         
-        delete[] rowIndices;
-        delete[] colIndices;
-        delete[] values;
+        // Minimum traffic: values + column indices + row pointers + x + y; SELL
+        // streams all of its arrays, padding and permutation included
+        double csrBytes = nnz * 12.0 + rows * 12.0 + cols * 8.0;
+        double csrFloatBytes = nnz * 8.0 + rows * 8.0 + cols * 4.0;
+        double sellBytes = sell.getMemoryUsage() + rows * 8.0 + cols * 8.0;
         
-        rowIndices = newRowIndices;
-        colIndices = newColIndices;
-        values = newValues;
-    }
-    
-    // Shift elements to the right from given index
-    void shiftRight(int index) {
-        for (int i = size; i > index; i--) {
-            rowIndices[i] = rowIndices[i - 1];
-            colIndices[i] = colIndices[i - 1];
-            values[i] = values[i - 1];
-        }
-    }
-    
-    // Shift elements to the left from given index
-    void shiftLeft(int index) {
-        for (int i = index; i < size - 1; i++) {
-            rowIndices[i] = rowIndices[i + 1];
-            colIndices[i] = colIndices[i + 1];
-            values[i] = values[i + 1];
-        }
-    }
-    
-public:
-    // Constructor
-    SparseMatrixArray(int r, int c) : rows(r), cols(c), capacity(10), size(0) {
-        rowIndices = new int[capacity];
-        colIndices = new int[capacity];
-        values = new double[capacity];
-    }
-    
-    // Destructor
-    ~SparseMatrixArray() {
-        delete[] rowIndices;
-        delete[] colIndices;
-        delete[] values;
+        cout << "\n" << testCase.name << ": " << rows << " rows, " << (long long)nnz 
+             << " non-zeros, SELL padding " << setprecision(1) 
+             << 100.0 * sell.getPaddingRatio() << "%" << endl;
+        cout << left << setw(26) << "Kernel" << right << setw(12) << "ms" 
+             << setw(12) << "GFLOP/s" << setw(12) << "GB/s" << setw(12) << "% triad" << endl;
+        
+        auto report = [&](const string& kernel, double seconds, double bytes) {
+            double bandwidth = bytes / seconds / 1e9;
+            cout << left << setw(26) << kernel << right << setprecision(3) 
+                 << setw(12) << seconds * 1000.0 
+                 << setw(12) << 2.0 * nnz / seconds / 1e9
+                 << setw(12) << bandwidth 
+                 << setw(11) << setprecision(1) << 100.0 * bandwidth / streamBandwidth << "%" << endl;
+        };
+        
+        report("COO (SparseMatrixArray)", timePerCall([&]() { matrix.multiply(x.data(), y.data()); }, 10), csrBytes);
+        report("CSR 1 thread", timePerCall([&]() { csr.multiply(x.data(), y.data(), 1); }, 10), csrBytes);
+        report("CSR all threads", timePerCall([&]() { csr.multiply(x.data(), y.data()); }, 10), csrBytes);
+        report("SELL-8-256 1 thread", timePerCall([&]() { sell.multiply(x.data(), y.data(), 1); }, 10), sellBytes);
+        report("SELL-8-256 all threads", timePerCall([&]() { sell.multiply(x.data(), y.data()); }, 10), sellBytes);
+        report("CSR float/u32 1 thread", timePerCall([&]() { csrFloat.multiply(xFloat.data(), yFloat.data(), 1); }, 10), csrFloatBytes);
+        report("CSR float/u32 all threads", timePerCall([&]() { csrFloat.multiply(xFloat.data(), yFloat.data()); }, 10), csrFloatBytes);
     }
+}
+
+// Compare BSR against CSR on FEM-style matrices with dense blocks
+void runBSRBenchmark() {
+    cout << "BSR benchmark (" << defaultThreadCount() << " hardware threads)" << endl;
     
-    // Copy constructor
-    SparseMatrixArray(const SparseMatrixArray& other) 
-        : rows(other.rows), cols(other.cols), capacity(other.capacity), size(other.size) {
-        rowIndices = new int[capacity];
-        colIndices = new int[capacity];
-        values = new double[capacity];
+    for (int blockSize : {3, 4}) {
+        SparseMatrixArray matrix = blockPoissonMatrix2D(250, blockSize);
+        int n = matrix.getDimensions().first;
+        double nnz = matrix.getNonZeroCount();
+        int detected = detectBlockSize(matrix);
+        
+        CSRMatrix csr = matrix.toCSR();
+        vector<double> x(n, 1.0), yCsr(n, 0.0), yBsr(n, 0.0);
+        double csrIndexBytes = sizeof(int) * (csr.getRowPointers().size() + csr.getColumnIndices().size());
+        
+        cout << "\n" << blockSize << "x" << blockSize << " blocks: " << n << " rows, " 
+             << (long long)nnz << " non-zeros, detected block size " << detected << endl;
+        cout << left << setw(22) << "Format" << right << setw(14) << "index B/nnz" 
+             << setw(12) << "SpMV ms" << setw(12) << "SpMV MT ms" << setw(12) << "SpGEMM ms" << endl;
         
-        for (int i = 0; i < size; i++) {
-            rowIndices[i] = other.rowIndices[i];
-            colIndices[i] = other.colIndices[i];
-            values[i] = other.values[i];
+        auto report = [&](const string& format, double indexBytes, double spmv, double spmvThreads, double spgemm) {
+            cout << left << setw(22) << format << right << fixed << setprecision(3) 
+                 << setw(14) << indexBytes / nnz << setw(12) << spmv * 1000.0 
+                 << setw(12) << spmvThreads * 1000.0 << setw(12) << spgemm * 1000.0 << endl;
+        };
+        
+        report("COO", 2.0 * sizeof(int) * nnz,
+               timePerCall([&]() { matrix.multiply(x.data(), yCsr.data()); }, 10), 0.0, 0.0);
+        report("CSR", csrIndexBytes,
+               timePerCall([&]() { csr.multiply(x.data(), yCsr.data(), 1); }, 10),
+               timePerCall([&]() { csr.multiply(x.data(), yCsr.data()); }, 10),
+               timePerCall([&]() { csr.multiply(csr); }, 1));
+        
+        withBlockSize(detected, [&](auto b) {
+            BSRMatrix<decltype(b)::value> bsr(csr);
+            double spmv = timePerCall([&]() { bsr.multiply(x.data(), yBsr.data(), 1); }, 10);
+            double spmvThreads = timePerCall([&]() { bsr.multiply(x.data(), yBsr.data()); }, 10);
+            double spgemm = timePerCall([&]() { bsr.multiply(bsr); }, 1);
+            report("BSR " + to_string(decltype(b)::value) + "x" + to_string(decltype(b)::value),
+                   bsr.getIndexMemoryUsage(), spmv, spmvThreads, spgemm);
+        });
+        
+        double maxError = 0.0;
+        for (int i = 0; i < n; i++) {
+            maxError = max(maxError, fabs(yCsr[i] - yBsr[i]));
         }
+        cout << "Max |CSR - BSR| in SpMV: " << scientific << maxError << defaultfloat << endl;
     }
+}
+
+// Compare sparse x dense (SpMM) against one SpMV per dense column on graph-like
+// matrices with feature widths of 64-256 columns
+void runSpMMBenchmark() {
+    cout << "SpMM benchmark (" << defaultThreadCount() << " hardware threads)" << endl;
     
-    // Assignment operator
-    SparseMatrixArray& operator=(const SparseMatrixArray& other) {
-        if (this != &other) {
-            delete[] rowIndices;
-            delete[] colIndices;
-            delete[] values;
-            
-            rows = other.rows;
-            cols = other.cols;
-            capacity = other.capacity;
-            size = other.size;
-            
-            rowIndices = new int[capacity];
-            colIndices = new int[capacity];
-            values = new double[capacity];
-            
-            for (int i = 0; i < size; i++) {
-                rowIndices[i] = other.rowIndices[i];
-                colIndices[i] = other.colIndices[i];
-                values[i] = other.values[i];
-            }
-        }
-        return *this;
-    }
+    struct Case { string name; SparseMatrixArray matrix; };
+    vector<Case> cases;
+    cases.push_back({"random 200K, 10/row", randomSparseMatrix(200000, 200000, 10, 1)});
+    cases.push_back({"power-law 200K, ~10/row", powerLawSparseMatrix(200000, 10, 2)});
     
-    // Insert a value at given position
-    void insert(int row, int col, double value) {
-        if (row < 0 || row >= rows || col < 0 || col >= cols) {
-            throw out_of_range("Index out of bounds");
-        }
+    for (const Case& testCase : cases) {
+        CSRMatrix a = testCase.matrix.toCSR();
+        int rows = a.getDimensions().first;
+        int cols = a.getDimensions().second;
+        double nnz = a.getNonZeroCount();
         
-        // If value is zero, remove the element if it exists
-        if (value == 0.0) {
-            remove(row, col);
-            return;
-        }
-        
-        int index = findElementIndex(row, col);
+        cout << "\n" << testCase.name << ": " << rows << " rows, " << (long long)nnz << " non-zeros" << endl;
+        cout << right << setw(6) << "k" << setw(16) << "SpMV loop ms" << setw(14) << "SpMM ms" 
+             << setw(14) << "SpMM MT ms" << setw(12) << "GFLOP/s" << setw(10) << "speedup" 
+             << setw(12) << "max diff" << endl;
         
-        if (index != -1) {
-            // Element exists, update its value
-            values[index] = value;
-        } else {
-            // Element doesn't exist, insert new element
-            if (size >= capacity) {
-                resize();
+        for (int k : {64, 128, 256}) {
+            mt19937 rng(k);
+            uniform_real_distribution<double> dist(-1.0, 1.0);
+            vector<double> b((size_t)cols * k);
+            for (double& value : b) {
+                value = dist(rng);
             }
+            vector<double> c((size_t)rows * k), cLoop((size_t)rows * k);
             
-            int insertPos = findInsertionPoint(row, col);
-            shiftRight(insertPos);
+            // Baseline: gather each dense column, run SpMV, scatter the result
+            vector<double> x(cols), y(rows);
+            double loop = timePerCall([&]() {
+                for (int j = 0; j < k; j++) {
+                    for (int i = 0; i < cols; i++) x[i] = b[(size_t)i * k + j];
+                    a.multiply(x.data(), y.data(), 1);
+                    for (int i = 0; i < rows; i++) cLoop[(size_t)i * k + j] = y[i];
+                }
+            }, 1);
+            double single = timePerCall([&]() { a.multiplyDense(b.data(), k, c.data(), 1); }, 3);
+            double threaded = timePerCall([&]() { a.multiplyDense(b.data(), k, c.data()); }, 3);
             
-            rowIndices[insertPos] = row;
-            colIndices[insertPos] = col;
-            values[insertPos] = value;
-            size++;
+            double maxDiff = 0.0;
+            for (size_t i = 0; i < c.size(); i++) {
+                maxDiff = max(maxDiff, fabs(c[i] - cLoop[i]));
+            }
+            cout << setw(6) << k << fixed << setprecision(2) << setw(16) << loop * 1000.0 
+                 << setw(14) << single * 1000.0 << setw(14) << threaded * 1000.0 
+                 << setw(12) << 2.0 * nnz * k / threaded / 1e9 << setw(9) << setprecision(1) 
+                 << loop / threaded << "x" << setw(12) << scientific << setprecision(1) << maxDiff 
+                 << defaultfloat << endl;
         }
     }
+}
+
+// Ingest throughput of ConcurrentSparseBuilder across thread counts against a
+// single-threaded fromTriplets build of the same non-zeros
+void runBuilderBenchmark() {
+    const int n = 1000000;
+    const size_t total = 20000000;
+    cout << "Concurrent builder benchmark (" << defaultThreadCount() << " hardware threads, " 
+         << total << " non-zeros into " << n << "x" << n << ")" << endl;
     
-    // Get value at given position
-    double get(int row, int col) const {
-        if (row < 0 || row >= rows || col < 0 || col >= cols) {
-            throw out_of_range("Index out of bounds");
+    // Non-zeros of block b come from a fixed xorshift stream, so every run
+    // produces the same multiset whatever the thread count
+    const size_t BLOCK = 1 << 16;
+    auto generate = [&](size_t block, auto emit) {
+        uint64_t state = 0x9E3779B97F4A7C15ull * (block + 1);
+        size_t end = min(total, (block + 1) * BLOCK);
+        for (size_t k = block * BLOCK; k < end; k++) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            emit((int)(state % n), (int)((state >> 32) % n), 1.0);
         }
-        
-        int index = findElementIndex(row, col);
-        return (index != -1) ? values[index] : 0.0;
-    }
+    };
+    size_t numBlocks = (total + BLOCK - 1) / BLOCK;
     
-    // Set value at given position (alias for insert)
-    void set(int row, int col, double value) {
-        insert(row, col, value);
-    }
+    cout << left << setw(24) << "Build" << right << setw(12) << "ingest ms" << setw(14) 
+         << "finalize ms" << setw(14) << "M nnz/s" << setw(12) << "nnz" << endl;
+    auto report = [&](const string& name, double ingest, double finalize, long long nnz) {
+        cout << left << setw(24) << name << right << fixed << setprecision(1) << setw(12) << ingest * 1000.0 
+             << setw(14) << finalize * 1000.0 << setw(14) << total / (ingest + finalize) / 1e6 
+             << setw(12) << nnz << endl;
+    };
     
-    // Remove element at given position
-    void remove(int row, int col) {
-        int index = findElementIndex(row, col);
-        if (index != -1) {
-            shiftLeft(index);
-            size--;
-        }
+    auto startTime = chrono::steady_clock::now();
+    vector<Triplet> triplets;
+    triplets.reserve(total);
+    for (size_t block = 0; block < numBlocks; block++) {
+        generate(block, [&](int row, int col, double value) { triplets.push_back({row, col, value}); });
     }
+    double ingest = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    startTime = chrono::steady_clock::now();
+    SparseMatrixArray reference = SparseMatrixArray::fromTriplets(n, n, std::move(triplets));
+    report("fromTriplets 1 thread", ingest, chrono::duration<double>(chrono::steady_clock::now() - startTime).count(),
+           reference.getNonZeroCount());
     
-    // Add two sparse matrices
-    SparseMatrixArray add(const SparseMatrixArray& other) const {
-        if (rows != other.rows || cols != other.cols) {
-            throw invalid_argument("Matrix dimensions must match for addition");
-        }
-        
-        SparseMatrixArray result(rows, cols);
-        
-        // Copy all elements from this matrix
-        for (int i = 0; i < size; i++) {
-            result.insert(rowIndices[i], colIndices[i], values[i]);
-        }
+    vector<int> threadCounts = {1, 2, 4, defaultThreadCount()};
+    sort(threadCounts.begin(), threadCounts.end());
+    threadCounts.erase(unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+    for (int numThreads : threadCounts) {
+        ConcurrentSparseBuilder builder(n, n, numThreads);
+        startTime = chrono::steady_clock::now();
+        parallelForBlocks(numBlocks, 1, numThreads, [&](size_t begin, size_t end, int threadId) {
+            for (size_t block = begin; block < end; block++) {
+                generate(block, [&](int row, int col, double value) { builder.insert(threadId, row, col, value); });
+            }
+        });
+        ingest = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+        startTime = chrono::steady_clock::now();
+        CSRMatrix csr = builder.finalize(numThreads);
+        double finalize = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
         
-        // Add elements from other matrix
-        for (int i = 0; i < other.size; i++) {
-            double currentValue = result.get(other.rowIndices[i], other.colIndices[i]);
-            result.insert(other.rowIndices[i], other.colIndices[i], 
-                         currentValue + other.values[i]);
+        report("builder " + to_string(numThreads) + " thread" + (numThreads > 1 ? "s" : ""), ingest, finalize,
+               csr.getNonZeroCount());
+        if (!sparseEqual(csr, reference)) {
+            cout << "MISMATCH against fromTriplets" << endl;
         }
-        
-        return result;
     }
+}
+
+// Convergence and time-to-solution of CG and BiCGSTAB with each preconditioner on
+// model problems plus any Matrix Market files given; b = A * ones, x0 = 0
+void runSolverBenchmark(const vector<string>& files) {
+    cout << "Solver benchmark (" << defaultThreadCount() << " hardware threads, tolerance 1e-8)" << endl;
     
-    // Multiply two sparse matrices
-    SparseMatrixArray multiply(const SparseMatrixArray& other) const {
-        if (cols != other.rows) {
-            throw invalid_argument("Matrix dimensions incompatible for multiplication");
+    struct Problem { string name; SparseMatrixArray matrix; bool symmetric; };
+    vector<Problem> problems;
+    problems.push_back({"poisson2d 500x500", poissonMatrix2D(500), true});
+    problems.push_back({"block poisson2d 150x150, 3x3", blockPoissonMatrix2D(150, 3), true});
+    problems.push_back({"convection-diffusion 500x500", convectionDiffusionMatrix2D(500, 0.5), false});
+    for (const string& file : files) {
+        try {
+            SparseMatrixArray matrix = SparseMatrixArray::readMatrixMarket(file);
+            bool symmetric = sparseEqual(matrix, matrix.transpose(), 0.0);
+            problems.push_back({file, std::move(matrix), symmetric});
+        } catch (const exception& e) {
+            cout << file << ": " << e.what() << endl;
         }
-        
-        SparseMatrixArray result(rows, other.cols);
-        
-        // For each non-zero element in this matrix
-        for (int i = 0; i < size; i++) {
-            // For each non-zero element in other matrix
-            for (int j = 0; j < other.size; j++) {
-                if (colIndices[i] == other.rowIndices[j]) {
-                    double product = values[i] * other.values[j];
-                    double existingValue = result.get(rowIndices[i], other.colIndices[j]);
-                    result.insert(rowIndices[i], other.colIndices[j], 
-                                existingValue + product);
-                }
-            }
-        }
-        
-        return result;
     }
     
-    // Transpose the matrix
-    SparseMatrixArray transpose() const {
-        SparseMatrixArray result(cols, rows);
+    for (const Problem& problem : problems) {
+        CSRMatrix a = problem.matrix.toCSR();
+        int n = a.getDimensions().first;
+        vector<double> b = a.multiply(vector<double>(n, 1.0));
         
-        for (int i = 0; i < size; i++) {
-            result.insert(colIndices[i], rowIndices[i], values[i]);
-        }
+        cout << "\n" << problem.name << ": " << n << " rows, " << a.getNonZeroCount() 
+             << " non-zeros, " << (problem.symmetric ? "symmetric" : "non-symmetric") << endl;
+        cout << left << setw(10) << "Solver" << setw(10) << "Precond" << right << setw(8) << "iters" 
+             << setw(12) << "residual" << setw(12) << "setup ms" << setw(14) << "1 thread ms" 
+             << setw(14) << "threads ms" << endl;
         
-        return result;
-    }
-    
-    // Display the matrix
-    void display() const {
-        cout << "Sparse Matrix (" << rows << "x" << cols << "):" << endl;
-        for (int i = 0; i < rows; i++) {
-            for (int j = 0; j < cols; j++) {
-                cout << get(i, j) << "\t";
+        auto run = [&](const string& solver, const string& precond, auto makePreconditioner) {
+            auto startTime = chrono::steady_clock::now();
+            auto m = makePreconditioner();
+            double setup = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+            
+            SolverResult result = {};
+            auto solve = [&](int numThreads) {
+                vector<double> x;
+                auto solveStart = chrono::steady_clock::now();
+                result = solver == "CG" ? conjugateGradient(a, b, x, m, 1e-8, 5000, numThreads)
+                                        : biCGStab(a, b, x, m, 1e-8, 5000, numThreads);
+                return chrono::duration<double>(chrono::steady_clock::now() - solveStart).count();
+            };
+            double serial = solve(1);
+            double threaded = solve(0);
+            
+            cout << left << setw(10) << solver << setw(10) << precond << right << setw(8) 
+                 << (result.converged ? to_string(result.iterations) : "-") << setw(12) << scientific 
+                 << setprecision(2) << result.residual << fixed << setprecision(1) << setw(12) << setup * 1000.0 
+                 << setw(14) << serial * 1000.0 << setw(14) << threaded * 1000.0 << endl;
+        };
+        
+        for (string solver : {"CG", "BiCGSTAB"}) {
+            if (solver == "CG" && !problem.symmetric) {
+                continue;
+            }
+            try {
+                run(solver, "none", [&]() { return IdentityPreconditioner(a); });
+                run(solver, "Jacobi", [&]() { return JacobiPreconditioner(a); });
+                run(solver, "ILU(0)", [&]() { return ILU0Preconditioner(a); });
+            } catch (const exception& e) {
+                cout << solver << ": " << e.what() << endl;
             }
-            cout << endl;
-        }
-        cout << endl;
-    }
-    
-    // Display only non-zero elements
-    void displaySparse() const {
-        cout << "Non-zero elements:" << endl;
-        for (int i = 0; i < size; i++) {
-            cout << "(" << rowIndices[i] << ", " << colIndices[i] << ") = " 
-                 << values[i] << endl;
         }
-        cout << endl;
     }
-    
-    // Get number of non-zero elements
-    int getNonZeroCount() const {
-        return size;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench-spmv") {
+        runSpMVBenchmark();
+        return 0;
     }
-    
-    // Check if matrix is empty (all zeros)
-    bool isEmpty() const {
-        return size == 0;
+    if (argc > 1 && string(argv[1]) == "--bench-bsr") {
+        runBSRBenchmark();
+        return 0;
     }
-    
-    // Clear all elements
-    void clear() {
-        size = 0;
+    if (argc > 1 && string(argv[1]) == "--bench-spmm") {
+        runSpMMBenchmark();
+        return 0;
     }
-    
-    // Get matrix dimensions
-    pair<int, int> getDimensions() const {
-        return make_pair(rows, cols);
+    if (argc > 1 && string(argv[1]) == "--bench-builder") {
+        runBuilderBenchmark();
+        return 0;
     }
-    
-    // Get memory usage (approximate)
-    int getMemoryUsage() const {
-        return sizeof(int) * capacity * 2 + sizeof(double) * capacity + sizeof(*this);
+    if (argc > 1 && string(argv[1]) == "--bench-solvers") {
+        runSolverBenchmark(vector<string>(argv + 2, argv + argc));
+        return 0;
     }
     
-    // Get capacity
-    int getCapacity() const {
-        return capacity;
+    // Convert between Matrix Market (.mtx) and binary CSR: --convert <in> <out>
+    if (argc > 3 && string(argv[1]) == "--convert") {
+        auto isMtx = [](const string& name) {
+            return name.size() >= 4 && name.compare(name.size() - 4, 4, ".mtx") == 0;
+        };
+        try {
+            auto startTime = chrono::steady_clock::now();
+            SparseMatrixArray loaded = isMtx(argv[2]) ? SparseMatrixArray::readMatrixMarket(argv[2])
+                                                      : SparseMatrixArray::readBinary(argv[2]);
+            double loadTime = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+            
+            if (isMtx(argv[3])) {
+                loaded.writeMatrixMarket(argv[3]);
+            } else {
+                loaded.writeBinary(argv[3]);
+            }
+            cout << argv[2] << ": " << loaded.getDimensions().first << "x" 
+                 << loaded.getDimensions().second << ", " << loaded.getNonZeroCount() 
+                 << " non-zeros, loaded in " << loadTime << " s" << endl;
+        } catch (const exception& e) {
+            cout << "Error: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
     }
     
-    // Get efficiency ratio (non-zero elements / capacity)
-    double getEfficiency() const {
-        return (capacity > 0) ? (double)size / capacity : 0.0;
-    }
-};
-
-int main() {
     // Example usage
     SparseMatrixArray matrix(3, 3);
     matrix.insert(0, 0, 1.0);
@@ -330,5 +387,41 @@ int main() {
     cout << "Sparse Matrix:" << endl;
     matrix.display();
     
+    // CSR form: O(1) row access, SpMV and SpGEMM
+    CSRMatrix csr = matrix.toCSR();
+    CSRRow row = csr.getRow(2);
+    cout << "Row 2 has " << row.count << " non-zeros" << endl;
+    
+    vector<double> y = csr.multiply(vector<double>{1.0, 1.0, 1.0});
+    cout << "A * [1 1 1] = [" << y[0] << " " << y[1] << " " << y[2] << "]" << endl;
+    
+    cout << "A * A (CSR):" << endl;
+    SparseMatrixArray(csr.multiply(csr)).display();
+    
+    // Bulk construction from unsorted triplets; duplicates are summed
+    SparseMatrixArray bulk = SparseMatrixArray::fromTriplets(3, 3, {
+        {2, 2, 5.0}, {0, 2, 2.0}, {1, 1, 1.0}, {0, 0, 1.0}, {2, 0, 4.0}, {1, 1, 2.0}
+    });
+    bulk.insertBatch({{1, 1, 0.0}, {1, 2, 7.0}});
+    cout << "Bulk-built matrix:" << endl;
+    bulk.displaySparse();
+    
+    // SpMV on raw arrays: COO, CSR and SELL-C-sigma agree
+    double x[3] = {1.0, 2.0, 3.0};
+    double yCoo[3], yCsr[3], ySell[3];
+    matrix.multiply(x, yCoo);
+    csr.multiply(x, yCsr);
+    SellCSigmaMatrix(csr, 4, 2).multiply(x, ySell);
+    bool kernelsAgree = equal(yCoo, yCoo + 3, yCsr) && equal(yCoo, yCoo + 3, ySell);
+    cout << "A * [1 2 3] = [" << yCoo[0] << " " << yCoo[1] << " " << yCoo[2] << "], COO/CSR/SELL " 
+         << (kernelsAgree ? "match" : "MISMATCH") << endl;
+    
+    // Solve the 2D Poisson problem with ILU(0)-preconditioned conjugate gradient
+    CSRMatrix poisson = poissonMatrix2D(32).toCSR();
+    vector<double> rhs(poisson.getDimensions().first, 1.0), solution;
+    SolverResult result = conjugateGradient(poisson, rhs, solution, ILU0Preconditioner(poisson));
+    cout << "Poisson 32x32 with CG + ILU(0): " << result.iterations << " iterations, residual " 
+         << result.residual << endl;
+    
     return 0;
 }
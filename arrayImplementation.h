@@ -0,0 +1,2105 @@
+#ifndef ARRAY_IMPLEMENTATION_H
+#define ARRAY_IMPLEMENTATION_H
+
+// Array-based sparse matrices: sorted COO (SparseMatrixArray), CSR (BasicCSRMatrix,
+// CSRMatrix for double/int), SELL-C-sigma (SellCSigmaMatrix) and block sparse
+// row (BSRMatrix), plus a multi-threaded CSR builder (ConcurrentSparseBuilder).
+
+#include <iostream>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+#include <string>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <atomic>
+#include <random>
+#include "sparse_io.h"
+#include "sparseMatrix.h"
+
+// Read-only view of one CSR row: column indices and values of its non-zeros
+template <typename Value, typename Index>
+struct BasicCSRRow {
+    const Index* cols;
+    const Value* values;
+    Index count;
+};
+
+// BasicCSRMatrix class using compressed sparse row storage (row pointers + columns
+// + values), parameterised on the value type (float, double, int) and the index
+// type (int, uint32_t, uint64_t). Row pointers use the index type too, so a matrix
+// holds at most its maximum number of non-zeros.
+template <typename Value, typename Index>
+class BasicCSRMatrix {
+    static_assert(isSparseValue<Value>::value, "Value type must be float, double or int");
+    static_assert(isSparseIndex<Index>::value, "Index type must be int, uint32_t or uint64_t");
+    
+private:
+    Index rows;
+    Index cols;
+    std::vector<Index> rowPtr;  // rows + 1 entries; row i occupies [rowPtr[i], rowPtr[i + 1])
+    std::vector<Index> colIdx;  // Column index of each non-zero, sorted within a row
+    std::vector<Value> values;  // Value of each non-zero
+    
+public:
+    using value_type = Value;
+    using index_type = Index;
+    
+    // Constructor for an empty matrix
+    BasicCSRMatrix(Index r, Index c) : rows(r), cols(c) {
+        if (isNegativeIndex(r) || isNegativeIndex(c)) {
+            throw std::invalid_argument("Matrix dimensions must be non-negative");
+        }
+        rowPtr.assign((size_t)r + 1, 0);
+    }
+    
+    // Constructor taking ownership of prepared CSR arrays
+    BasicCSRMatrix(Index r, Index c, std::vector<Index> rowPointers, std::vector<Index> columns,
+                   std::vector<Value> vals)
+        : rows(r), cols(c), rowPtr(std::move(rowPointers)), colIdx(std::move(columns)),
+          values(std::move(vals)) {
+        if (isNegativeIndex(r) || isNegativeIndex(c)) {
+            throw std::invalid_argument("Matrix dimensions must be non-negative");
+        }
+        if (rowPtr.size() != (size_t)rows + 1 || rowPtr[0] != 0 ||
+            colIdx.size() != values.size() || (size_t)rowPtr[rows] != colIdx.size()) {
+            throw std::invalid_argument("Inconsistent CSR arrays");
+        }
+    }
+    
+    // Get value at given position (binary search within the row)
+    Value get(Index row, Index col) const {
+        if (isNegativeIndex(row) || row >= rows || isNegativeIndex(col) || col >= cols) {
+            throw std::out_of_range("Index out of bounds");
+        }
+        
+        const Index* begin = colIdx.data() + rowPtr[row];
+        const Index* end = colIdx.data() + rowPtr[row + 1];
+        const Index* it = std::lower_bound(begin, end, col);
+        return (it != end && *it == col) ? values[it - colIdx.data()] : Value(0);
+    }
+    
+    // Get the non-zeros of one row in O(1)
+    BasicCSRRow<Value, Index> getRow(Index row) const {
+        if (isNegativeIndex(row) || row >= rows) {
+            throw std::out_of_range("Row index out of bounds");
+        }
+        Index start = rowPtr[row];
+        return {colIdx.data() + start, values.data() + start, rowPtr[row + 1] - start};
+    }
+    
+    // Extract rows [beginRow, endRow) as a new matrix
+    BasicCSRMatrix sliceRows(Index beginRow, Index endRow) const {
+        if (isNegativeIndex(beginRow) || endRow > rows || beginRow > endRow) {
+            throw std::out_of_range("Row range out of bounds");
+        }
+        
+        Index offset = rowPtr[beginRow];
+        std::vector<Index> slicePtr((size_t)(endRow - beginRow) + 1);
+        for (Index i = beginRow; i <= endRow; i++) {
+            slicePtr[i - beginRow] = rowPtr[i] - offset;
+        }
+        std::vector<Index> sliceCols(colIdx.begin() + offset, colIdx.begin() + rowPtr[endRow]);
+        std::vector<Value> sliceValues(values.begin() + offset, values.begin() + rowPtr[endRow]);
+        
+        return BasicCSRMatrix(endRow - beginRow, cols, std::move(slicePtr),
+                              std::move(sliceCols), std::move(sliceValues));
+    }
+    
+    // Sparse matrix-vector product y = A * x
+    std::vector<Value> multiply(const std::vector<Value>& x) const {
+        if (x.size() != (size_t)cols) {
+            throw std::invalid_argument("Vector length must match matrix columns");
+        }
+        
+        std::vector<Value> y(rows, Value(0));
+        multiply(x.data(), y.data());
+        return y;
+    }
+    
+    // Sparse matrix-vector product y = A * x on raw arrays (x has cols entries,
+    // y has rows entries). Rows are split into ranges of roughly equal nnz, one
+    // per thread; numThreads = 0 uses every hardware thread for large matrices.
+    void multiply(const Value* x, Value* y, int numThreads = 0) const {
+        const size_t MIN_NNZ_PER_THREAD = 50000;
+        size_t nnz = getNonZeroCount();
+        if (numThreads <= 0) {
+            numThreads = defaultThreadCount();
+        }
+        numThreads = (int)std::max<size_t>(1, std::min<size_t>(numThreads, nnz / MIN_NNZ_PER_THREAD));
+        
+        std::vector<Index> bounds = balancedRowRanges(numThreads);
+        parallelForBlocks(numThreads, 1, numThreads, [&](size_t begin, size_t end, int) {
+            for (size_t part = begin; part < end; part++) {
+                for (Index i = bounds[part]; i < bounds[part + 1]; i++) {
+                    Index start = rowPtr[i];
+                    y[i] = sparseRowDot(colIdx.data() + start, values.data() + start,
+                                        rowPtr[i + 1] - start, x);
+                }
+            }
+        });
+    }
+    
+    // Sparse x dense product C = A * B, where B (cols x k) and C (rows x k) are
+    // dense and row-major. Each output row is built in register tiles from the B
+    // rows its non-zeros select; rows are split across threads by nnz as in SpMV.
+    void multiplyDense(const Value* b, size_t k, Value* c, int numThreads = 0) const {
+        const size_t MIN_FLOPS_PER_THREAD = 500000;
+        size_t nnz = getNonZeroCount();
+        if (numThreads <= 0) {
+            numThreads = defaultThreadCount();
+        }
+        numThreads = (int)std::max<size_t>(1, std::min<size_t>(numThreads, nnz * k / MIN_FLOPS_PER_THREAD));
+        
+        std::vector<Index> bounds = balancedRowRanges(numThreads);
+        parallelForBlocks(numThreads, 1, numThreads, [&](size_t begin, size_t end, int) {
+            for (size_t part = begin; part < end; part++) {
+                for (Index i = bounds[part]; i < bounds[part + 1]; i++) {
+                    Index start = rowPtr[i];
+                    sparseRowTimesDense(colIdx.data() + start, values.data() + start,
+                                        (size_t)(rowPtr[i + 1] - start), b, k, k, c + (size_t)i * k);
+                }
+            }
+        });
+    }
+    
+    // Sparse x dense product on vectors; b holds cols x k values row-major and the
+    // result rows x k
+    std::vector<Value> multiplyDense(const std::vector<Value>& b, size_t k, int numThreads = 0) const {
+        if (b.size() != (size_t)cols * k) {
+            throw std::invalid_argument("Dense operand must have matrix columns x k entries");
+        }
+        
+        std::vector<Value> c((size_t)rows * k);
+        multiplyDense(b.data(), k, c.data(), numThreads);
+        return c;
+    }
+    
+    // Split the rows into numParts contiguous ranges holding about nnz / numParts
+    // entries each; range p is [bounds[p], bounds[p + 1])
+    std::vector<Index> balancedRowRanges(int numParts) const {
+        unsigned long long nnz = getNonZeroCount();
+        std::vector<Index> bounds(numParts + 1, rows);
+        bounds[0] = 0;
+        for (int p = 1; p < numParts; p++) {
+            Index target = (Index)(nnz * p / numParts);
+            Index row = (Index)(std::lower_bound(rowPtr.begin(), rowPtr.end(), target) - rowPtr.begin());
+            bounds[p] = std::min(std::max(row, bounds[p - 1]), rows);
+        }
+        return bounds;
+    }
+    
+    // Sparse matrix-matrix product (Gustavson): a symbolic pass sizes every output
+    // row, then a row-parallel numeric pass fills it using a dense accumulator per
+    // thread. numThreads = 0 uses every hardware thread.
+    BasicCSRMatrix multiply(const BasicCSRMatrix& other, int numThreads = 0) const {
+        if (cols != other.rows) {
+            throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
+        }
+        if (numThreads <= 0) {
+            numThreads = defaultThreadCount();
+        }
+        
+        const size_t BLOCK = 256;
+        const Index NO_ROW = std::numeric_limits<Index>::max();
+        Index outCols = other.cols;
+        
+        // Per-thread scratch: marker holds the last row that touched a column
+        std::vector<std::vector<Index>> markers(numThreads);
+        std::vector<std::vector<Value>> accumulators(numThreads);
+        
+        // Symbolic pass: count distinct output columns per row
+        std::vector<Index> resultPtr((size_t)rows + 1, 0);
+        parallelForBlocks(rows, BLOCK, numThreads, [&](size_t begin, size_t end, int t) {
+            std::vector<Index>& marker = markers[t];
+            if (marker.empty()) {
+                marker.assign(outCols, NO_ROW);
+            }
+            for (Index i = (Index)begin; i < (Index)end; i++) {
+                Index count = 0;
+                for (Index k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+                    Index mid = colIdx[k];
+                    for (Index m = other.rowPtr[mid]; m < other.rowPtr[mid + 1]; m++) {
+                        Index j = other.colIdx[m];
+                        if (marker[j] != i) {
+                            marker[j] = i;
+                            count++;
+                        }
+                    }
+                }
+                resultPtr[i + 1] = count;
+            }
+        });
+        
+        for (Index i = 0; i < rows; i++) {
+            resultPtr[i + 1] += resultPtr[i];
+        }
+        
+        std::vector<Index> resultCols(resultPtr[rows]);
+        std::vector<Value> resultValues(resultPtr[rows]);
+        
+        for (std::vector<Index>& marker : markers) {
+            std::fill(marker.begin(), marker.end(), NO_ROW);
+        }
+        
+        // Numeric pass: each row writes into its own pre-sized slot
+        std::atomic<size_t> cancelled(0);
+        parallelForBlocks(rows, BLOCK, numThreads, [&](size_t begin, size_t end, int t) {
+            std::vector<Index>& marker = markers[t];
+            std::vector<Value>& accumulator = accumulators[t];
+            if (marker.empty()) {
+                marker.assign(outCols, NO_ROW);
+            }
+            if (accumulator.empty()) {
+                accumulator.assign(outCols, Value(0));
+            }
+            
+            size_t localCancelled = 0;
+            for (Index i = (Index)begin; i < (Index)end; i++) {
+                Index* rowCols = resultCols.data() + resultPtr[i];
+                Index count = 0;
+                for (Index k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+                    Index mid = colIdx[k];
+                    Value a = values[k];
+                    for (Index m = other.rowPtr[mid]; m < other.rowPtr[mid + 1]; m++) {
+                        Index j = other.colIdx[m];
+                        if (marker[j] != i) {
+                            marker[j] = i;
+                            rowCols[count++] = j;
+                            accumulator[j] = Value(0);
+                        }
+                        accumulator[j] += a * other.values[m];
+                    }
+                }
+                
+                std::sort(rowCols, rowCols + count);
+                Value* rowValues = resultValues.data() + resultPtr[i];
+                for (Index c = 0; c < count; c++) {
+                    rowValues[c] = accumulator[rowCols[c]];
+                    if (rowValues[c] == Value(0)) {
+                        localCancelled++;
+                    }
+                }
+            }
+            cancelled += localCancelled;
+        });
+        
+        BasicCSRMatrix result(rows, outCols, std::move(resultPtr),
+                              std::move(resultCols), std::move(resultValues));
+        if (cancelled > 0) {
+            result.dropZeros();
+        }
+        return result;
+    }
+    
+    // Transpose by counting sort in O(nnz + rows + cols); with numThreads > 1 the
+    // rows are split into nnz-balanced chunks that are counted and scattered in parallel
+    BasicCSRMatrix transpose(int numThreads = 1) const {
+        if (numThreads <= 0) {
+            numThreads = defaultThreadCount();
+        }
+        size_t nnz = getNonZeroCount();
+        int numChunks = (int)std::max<size_t>(1, std::min<size_t>(numThreads, nnz));
+        
+        std::vector<Index> chunkRows = balancedRowRanges(numChunks);
+        
+        std::vector<Index> resultPtr, resultIdx;
+        std::vector<Value> resultValues;
+        countingSortTranspose(cols, nnz, numChunks, numThreads,
+            [&](size_t chunk, auto emit) {
+                for (Index i = chunkRows[chunk]; i < chunkRows[chunk + 1]; i++) {
+                    for (Index k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+                        emit(i, colIdx[k], values[k]);
+                    }
+                }
+            }, resultPtr, resultIdx, resultValues);
+        
+        return BasicCSRMatrix(cols, rows, std::move(resultPtr), std::move(resultIdx),
+                              std::move(resultValues));
+    }
+    
+    // Remove explicitly stored zeros (e.g. from cancellation) in one pass
+    void dropZeros() {
+        Index out = 0;
+        Index start = 0;
+        for (Index i = 0; i < rows; i++) {
+            Index end = rowPtr[i + 1];
+            for (Index k = start; k < end; k++) {
+                if (values[k] != Value(0)) {
+                    colIdx[out] = colIdx[k];
+                    values[out] = values[k];
+                    out++;
+                }
+            }
+            start = end;
+            rowPtr[i + 1] = out;
+        }
+        colIdx.resize(out);
+        values.resize(out);
+    }
+    
+    // Call f(row, col, value) for every non-zero in (row, col) order
+    template <typename F>
+    void forEachNonZero(F f) const {
+        for (Index i = 0; i < rows; i++) {
+            for (Index k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+                f(i, colIdx[k], values[k]);
+            }
+        }
+    }
+    
+    // Call f(col, value) for the non-zeros of one row in column order
+    template <typename F>
+    void forEachInRow(Index row, F f) const {
+        for (Index k = rowPtr[row]; k < rowPtr[row + 1]; k++) {
+            f(colIdx[k], values[k]);
+        }
+    }
+    
+    // Display only non-zero elements
+    void displaySparse() const {
+        std::cout << "Non-zero elements:" << std::endl;
+        forEachNonZero([](Index row, Index col, Value value) {
+            std::cout << "(" << row << ", " << col << ") = " << value << std::endl;
+        });
+        std::cout << std::endl;
+    }
+    
+    // Get number of non-zero elements
+    Index getNonZeroCount() const {
+        return rowPtr[rows];
+    }
+    
+    // Get number of non-zero elements in one row
+    Index getRowNonZeroCount(Index row) const {
+        if (isNegativeIndex(row) || row >= rows) {
+            throw std::out_of_range("Row index out of bounds");
+        }
+        return rowPtr[row + 1] - rowPtr[row];
+    }
+    
+    // Get matrix dimensions
+    std::pair<Index, Index> getDimensions() const {
+        return std::make_pair(rows, cols);
+    }
+    
+    // Write in the binary CSR format (see sparse_io.h), which stores int indices
+    // and double values
+    void writeBinary(const std::string& filename) const {
+        static_assert(std::is_same<Value, double>::value && std::is_same<Index, int>::value,
+                      "Binary CSR files hold double values with int indices");
+        sparse_io::writeBinaryCSR(filename, rows, cols, rowPtr.data(), colIdx.data(), values.data());
+    }
+    
+    // Load a binary CSR file through mmap with one bulk copy per array
+    static BasicCSRMatrix readBinary(const std::string& filename) {
+        static_assert(std::is_same<Value, double>::value && std::is_same<Index, int>::value,
+                      "Binary CSR files hold double values with int indices");
+        sparse_io::MappedCSRFile file(filename);
+        const int* filePtr = file.getRowPointers();
+        int nnz = file.getNonZeroCount();
+        return BasicCSRMatrix(file.getRows(), file.getCols(),
+                              std::vector<int>(filePtr, filePtr + file.getRows() + 1),
+                              std::vector<int>(file.getColumnIndices(), file.getColumnIndices() + nnz),
+                              std::vector<double>(file.getValues(), file.getValues() + nnz));
+    }
+    
+    // Raw CSR arrays
+    const std::vector<Index>& getRowPointers() const { return rowPtr; }
+    const std::vector<Index>& getColumnIndices() const { return colIdx; }
+    const std::vector<Value>& getValues() const { return values; }
+    
+    // Get memory usage (approximate)
+    size_t getMemoryUsage() const {
+        return sizeof(Index) * (rowPtr.capacity() + colIdx.capacity()) +
+               sizeof(Value) * values.capacity() + sizeof(*this);
+    }
+};
+
+// The original double-valued, int-indexed CSR used by the other array formats
+using CSRMatrix = BasicCSRMatrix<double, int>;
+using CSRRow = BasicCSRRow<double, int>;
+
+// SellCSigmaMatrix class using SELL-C-sigma storage for SpMV on irregular rows:
+// rows are sorted by length within windows of sigma rows, grouped into chunks of
+// C rows, and each chunk is stored column-major padded to its longest row so one
+// SIMD lane handles one row
+class SellCSigmaMatrix {
+private:
+    int rows;
+    int cols;
+    int chunkHeight;          // C
+    int sortWindow;           // sigma
+    int nonZeros;             // Entries of the source matrix; every other slot is padding
+    std::vector<int> permutation;  // Sorted position -> original row
+    std::vector<int> chunkPtr;     // Offset of each chunk in colIdx/values
+    std::vector<int> chunkWidth;   // Padded row length of each chunk
+    std::vector<int> colIdx;       // Column-major within each chunk
+    std::vector<double> values;    // Padding entries are 0.0 with a valid column
+    
+public:
+    // Build from CSR; C must be a positive multiple of 4 for the AVX2 kernel
+    SellCSigmaMatrix(const CSRMatrix& csr, int c = 8, int sigma = 256) 
+        : rows(csr.getDimensions().first), cols(csr.getDimensions().second), 
+          chunkHeight(c), sortWindow(std::max(sigma, 1)), nonZeros(csr.getNonZeroCount()) {
+        if (c <= 0 || c % 4 != 0) {
+            throw std::invalid_argument("SELL chunk height must be a positive multiple of 4");
+        }
+        
+        const std::vector<int>& rowPtr = csr.getRowPointers();
+        auto rowLength = [&](int i) { return rowPtr[i + 1] - rowPtr[i]; };
+        
+        permutation.resize(rows);
+        for (int i = 0; i < rows; i++) {
+            permutation[i] = i;
+        }
+        for (int start = 0; start < rows; start += sortWindow) {
+            int end = std::min(start + sortWindow, rows);
+            std::stable_sort(permutation.begin() + start, permutation.begin() + end,
+                             [&](int a, int b) { return rowLength(a) > rowLength(b); });
+        }
+        
+        int numChunks = (rows + chunkHeight - 1) / chunkHeight;
+        chunkPtr.assign(numChunks + 1, 0);
+        chunkWidth.assign(numChunks, 0);
+        for (int chunk = 0; chunk < numChunks; chunk++) {
+            int width = 0;
+            for (int r = chunk * chunkHeight; r < std::min((chunk + 1) * chunkHeight, rows); r++) {
+                width = std::max(width, rowLength(permutation[r]));
+            }
+            chunkWidth[chunk] = width;
+            chunkPtr[chunk + 1] = chunkPtr[chunk] + width * chunkHeight;
+        }
+        
+        colIdx.assign(chunkPtr[numChunks], 0);
+        values.assign(chunkPtr[numChunks], 0.0);
+        const std::vector<int>& csrCols = csr.getColumnIndices();
+        const std::vector<double>& csrValues = csr.getValues();
+        for (int chunk = 0; chunk < numChunks; chunk++) {
+            for (int lane = 0; lane < chunkHeight; lane++) {
+                int r = chunk * chunkHeight + lane;
+                if (r >= rows) break;
+                int row = permutation[r];
+                int length = rowLength(row);
+                int lastCol = length > 0 ? csrCols[rowPtr[row] + length - 1] : 0;
+                for (int j = 0; j < chunkWidth[chunk]; j++) {
+                    int slot = chunkPtr[chunk] + j * chunkHeight + lane;
+                    if (j < length) {
+                        colIdx[slot] = csrCols[rowPtr[row] + j];
+                        values[slot] = csrValues[rowPtr[row] + j];
+                    } else {
+                        colIdx[slot] = lastCol; // Padding re-reads a cached x entry
+                    }
+                }
+            }
+        }
+    }
+    
+    // Sparse matrix-vector product y = A * x, chunks shared out across threads
+    void multiply(const double* x, double* y, int numThreads = 0) const {
+        int numChunks = (int)chunkWidth.size();
+        if (numThreads <= 0) {
+            numThreads = defaultThreadCount();
+        }
+        numThreads = std::max(1, std::min(numThreads, (int)(values.size() / 50000)));
+        
+        parallelForBlocks(numChunks, 64, numThreads, [&](int begin, int end, int) {
+            std::vector<double> sums(chunkHeight);
+            for (int chunk = begin; chunk < end; chunk++) {
+                const int* chunkCols = colIdx.data() + chunkPtr[chunk];
+                const double* chunkValues = values.data() + chunkPtr[chunk];
+                int width = chunkWidth[chunk];
+                
+                for (int lane = 0; lane < chunkHeight; lane += 4) {
+#ifdef __AVX2__
+                    __m256d acc = _mm256_setzero_pd();
+                    for (int j = 0; j < width; j++) {
+                        int offset = j * chunkHeight + lane;
+                        __m128i idx = _mm_loadu_si128((const __m128i*)(chunkCols + offset));
+                        __m256d xv = gatherDoubles(x, idx);
+                        __m256d av = _mm256_loadu_pd(chunkValues + offset);
+#ifdef __FMA__
+                        acc = _mm256_fmadd_pd(av, xv, acc);
+#else
+                        acc = _mm256_add_pd(acc, _mm256_mul_pd(av, xv));
+#endif
+                    }
+                    _mm256_storeu_pd(sums.data() + lane, acc);
+#else
+                    for (int l = lane; l < lane + 4; l++) {
+                        double sum = 0.0;
+                        for (int j = 0; j < width; j++) {
+                            int offset = j * chunkHeight + l;
+                            sum += chunkValues[offset] * x[chunkCols[offset]];
+                        }
+                        sums[l] = sum;
+                    }
+#endif
+                }
+                
+                for (int lane = 0; lane < chunkHeight; lane++) {
+                    int r = chunk * chunkHeight + lane;
+                    if (r >= rows) break;
+                    y[permutation[r]] = sums[lane];
+                }
+            }
+        });
+    }
+    
+    // Fraction of stored slots that are padding, from the slice layout (explicit
+    // zeros of the source matrix are real entries, not padding)
+    double getPaddingRatio() const {
+        if (values.empty()) return 0.0;
+        return (double)(values.size() - nonZeros) / values.size();
+    }
+    
+    // Get matrix dimensions
+    std::pair<int, int> getDimensions() const {
+        return std::make_pair(rows, cols);
+    }
+    
+    // Get memory usage (approximate)
+    size_t getMemoryUsage() const {
+        return sizeof(int) * (permutation.capacity() + chunkPtr.capacity() + 
+                              chunkWidth.capacity() + colIdx.capacity()) + 
+               sizeof(double) * values.capacity() + sizeof(*this);
+    }
+};
+
+// Block kernels for BSRMatrix. Blocks are B x B and stored column-major, so
+// column c of a block is contiguous and multiplying by a vector is B column
+// loads scaled by broadcast x entries: no gathers and no horizontal sums. The
+// common SIMD widths (double 2, 3 and 4, float 4 and 8) keep one block column per
+// register; other sizes use fixed-length loops the compiler unrolls.
+
+// sums[0..B) = sum over the blocks of one block row of block * x(block column).
+// xTail holds the zero-padded x entries of the partial last block column tailBlock.
+template <int B, typename Value, typename Index>
+inline void blockRowProduct(const Index* blockCols, const Value* blocks, Index count,
+                            const Value* x, const Value* xTail, Index tailBlock, Value* sums) {
+    auto blockOfX = [&](Index k) {
+        return blockCols[k] == tailBlock ? xTail : x + (size_t)blockCols[k] * B;
+    };
+#ifdef __AVX2__
+    if constexpr (B == 4 && std::is_same<Value, double>::value) {
+        __m256d acc0 = _mm256_setzero_pd();
+        __m256d acc1 = _mm256_setzero_pd();
+        for (Index k = 0; k < count; k++) {
+            const double* v = blocks + (size_t)k * 16;
+            const double* xb = blockOfX(k);
+            acc0 = multiplyAdd(_mm256_loadu_pd(v), _mm256_set1_pd(xb[0]), acc0);
+            acc1 = multiplyAdd(_mm256_loadu_pd(v + 4), _mm256_set1_pd(xb[1]), acc1);
+            acc0 = multiplyAdd(_mm256_loadu_pd(v + 8), _mm256_set1_pd(xb[2]), acc0);
+            acc1 = multiplyAdd(_mm256_loadu_pd(v + 12), _mm256_set1_pd(xb[3]), acc1);
+        }
+        _mm256_storeu_pd(sums, _mm256_add_pd(acc0, acc1));
+        return;
+    } else if constexpr (B == 3 && std::is_same<Value, double>::value) {
+        // Columns are 3 doubles: masked loads keep the fourth lane out of the next column
+        __m256i firstThree = _mm256_set_epi64x(0, -1, -1, -1);
+        __m256d acc0 = _mm256_setzero_pd();
+        __m256d acc1 = _mm256_setzero_pd();
+        for (Index k = 0; k < count; k++) {
+            const double* v = blocks + (size_t)k * 9;
+            const double* xb = blockOfX(k);
+            acc0 = multiplyAdd(_mm256_maskload_pd(v, firstThree), _mm256_set1_pd(xb[0]), acc0);
+            acc1 = multiplyAdd(_mm256_maskload_pd(v + 3, firstThree), _mm256_set1_pd(xb[1]), acc1);
+            acc0 = multiplyAdd(_mm256_maskload_pd(v + 6, firstThree), _mm256_set1_pd(xb[2]), acc0);
+        }
+        _mm256_maskstore_pd(sums, firstThree, _mm256_add_pd(acc0, acc1));
+        return;
+    } else if constexpr (B == 2 && std::is_same<Value, double>::value) {
+        __m128d acc = _mm_setzero_pd();
+        for (Index k = 0; k < count; k++) {
+            const double* v = blocks + (size_t)k * 4;
+            const double* xb = blockOfX(k);
+            acc = multiplyAdd(_mm_loadu_pd(v), _mm_set1_pd(xb[0]), acc);
+            acc = multiplyAdd(_mm_loadu_pd(v + 2), _mm_set1_pd(xb[1]), acc);
+        }
+        _mm_storeu_pd(sums, acc);
+        return;
+    } else if constexpr (B == 8 && std::is_same<Value, float>::value) {
+        __m256 acc0 = _mm256_setzero_ps();
+        __m256 acc1 = _mm256_setzero_ps();
+        for (Index k = 0; k < count; k++) {
+            const float* v = blocks + (size_t)k * 64;
+            const float* xb = blockOfX(k);
+            for (int c = 0; c < 8; c += 2) {
+                acc0 = multiplyAdd(_mm256_loadu_ps(v + c * 8), _mm256_set1_ps(xb[c]), acc0);
+                acc1 = multiplyAdd(_mm256_loadu_ps(v + c * 8 + 8), _mm256_set1_ps(xb[c + 1]), acc1);
+            }
+        }
+        _mm256_storeu_ps(sums, _mm256_add_ps(acc0, acc1));
+        return;
+    } else if constexpr (B == 4 && std::is_same<Value, float>::value) {
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+        for (Index k = 0; k < count; k++) {
+            const float* v = blocks + (size_t)k * 16;
+            const float* xb = blockOfX(k);
+            acc0 = multiplyAdd(_mm_loadu_ps(v), _mm_set1_ps(xb[0]), acc0);
+            acc1 = multiplyAdd(_mm_loadu_ps(v + 4), _mm_set1_ps(xb[1]), acc1);
+            acc0 = multiplyAdd(_mm_loadu_ps(v + 8), _mm_set1_ps(xb[2]), acc0);
+            acc1 = multiplyAdd(_mm_loadu_ps(v + 12), _mm_set1_ps(xb[3]), acc1);
+        }
+        _mm_storeu_ps(sums, _mm_add_ps(acc0, acc1));
+        return;
+    }
+#endif
+    Value acc[B] = {};
+    for (Index k = 0; k < count; k++) {
+        const Value* v = blocks + (size_t)k * B * B;
+        const Value* xb = blockOfX(k);
+        for (int c = 0; c < B; c++) {
+            for (int r = 0; r < B; r++) {
+                acc[r] += v[c * B + r] * xb[c];
+            }
+        }
+    }
+    for (int r = 0; r < B; r++) {
+        sums[r] = acc[r];
+    }
+}
+
+// c += a * b for column-major B x B blocks
+template <int B, typename Value>
+inline void blockMultiplyAdd(const Value* a, const Value* b, Value* c) {
+#ifdef __AVX2__
+    if constexpr (B == 4 && std::is_same<Value, double>::value) {
+        for (int j = 0; j < 4; j++) {
+            __m256d acc = _mm256_loadu_pd(c + j * 4);
+            for (int m = 0; m < 4; m++) {
+                acc = multiplyAdd(_mm256_loadu_pd(a + m * 4), _mm256_set1_pd(b[j * 4 + m]), acc);
+            }
+            _mm256_storeu_pd(c + j * 4, acc);
+        }
+        return;
+    } else if constexpr (B == 8 && std::is_same<Value, float>::value) {
+        for (int j = 0; j < 8; j++) {
+            __m256 acc = _mm256_loadu_ps(c + j * 8);
+            for (int m = 0; m < 8; m++) {
+                acc = multiplyAdd(_mm256_loadu_ps(a + m * 8), _mm256_set1_ps(b[j * 8 + m]), acc);
+            }
+            _mm256_storeu_ps(c + j * 8, acc);
+        }
+        return;
+    }
+#endif
+    for (int j = 0; j < B; j++) {
+        for (int m = 0; m < B; m++) {
+            Value scale = b[j * B + m];
+            for (int r = 0; r < B; r++) {
+                c[j * B + r] += a[m * B + r] * scale;
+            }
+        }
+    }
+}
+
+// BSRMatrix class using block sparse row storage: the matrix is tiled into B x B
+// blocks and only blocks holding a non-zero are stored, as B * B values with one
+// block column index, so index overhead per value drops by about B * B. B is a
+// compile-time constant so the block kernels unroll completely; use
+// detectBlockSize() and withBlockSize() to pick it from the data at run time.
+template <int B, typename Value = double, typename Index = int>
+class BSRMatrix {
+    static_assert(B >= 1 && B <= 8, "Block size must be between 1 and 8");
+    static_assert(isSparseValue<Value>::value, "Value type must be float, double or int");
+    static_assert(isSparseIndex<Index>::value, "Index type must be int, uint32_t or uint64_t");
+    
+private:
+    static constexpr int BLOCK_VALUES = B * B;
+    
+    Index rows;
+    Index cols;
+    Index blockRows;          // ceil(rows / B)
+    Index blockCols;          // ceil(cols / B)
+    Index nnz;                // Non-zero scalars (zeros filling out blocks are not counted)
+    std::vector<Index> blockPtr;   // blockRows + 1 entries; block row i owns [blockPtr[i], blockPtr[i + 1])
+    std::vector<Index> blockCol;   // Block column of each stored block, sorted within a block row
+    std::vector<Value> values;     // BLOCK_VALUES per block, column-major
+    
+    void countNonZeros() {
+        nnz = (Index)std::count_if(values.begin(), values.end(), [](Value v) { return v != Value(0); });
+    }
+    
+    // Remove blocks that became entirely zero (e.g. from cancellation)
+    void dropZeroBlocks() {
+        Index out = 0;
+        Index start = 0;
+        for (Index i = 0; i < blockRows; i++) {
+            Index end = blockPtr[i + 1];
+            for (Index k = start; k < end; k++) {
+                const Value* block = values.data() + (size_t)k * BLOCK_VALUES;
+                if (std::any_of(block, block + BLOCK_VALUES, [](Value v) { return v != Value(0); })) {
+                    blockCol[out] = blockCol[k];
+                    std::copy(block, block + BLOCK_VALUES, values.data() + (size_t)out * BLOCK_VALUES);
+                    out++;
+                }
+            }
+            start = end;
+            blockPtr[i + 1] = out;
+        }
+        blockCol.resize(out);
+        values.resize((size_t)out * BLOCK_VALUES);
+    }
+    
+public:
+    using value_type = Value;
+    using index_type = Index;
+    static constexpr int BLOCK_SIZE = B;
+    
+    // Constructor for an empty matrix
+    BSRMatrix(Index r, Index c)
+        : rows(r), cols(c), blockRows((r + B - 1) / B), blockCols((c + B - 1) / B), nnz(0) {
+        if (isNegativeIndex(r) || isNegativeIndex(c)) {
+            throw std::invalid_argument("Matrix dimensions must be non-negative");
+        }
+        blockPtr.assign((size_t)blockRows + 1, 0);
+    }
+    
+    // Constructor taking ownership of prepared BSR arrays
+    BSRMatrix(Index r, Index c, std::vector<Index> blockPointers, std::vector<Index> blockColumns,
+              std::vector<Value> blockValues)
+        : BSRMatrix(r, c) {
+        blockPtr = std::move(blockPointers);
+        blockCol = std::move(blockColumns);
+        values = std::move(blockValues);
+        if (blockPtr.size() != (size_t)blockRows + 1 || blockPtr[0] != 0 ||
+            (size_t)blockPtr[blockRows] != blockCol.size() ||
+            values.size() != blockCol.size() * BLOCK_VALUES) {
+            throw std::invalid_argument("Inconsistent BSR arrays");
+        }
+        countNonZeros();
+    }
+    
+    // Convert from CSR in one pass: the scalar rows of each block row are merged
+    // into their sorted set of blocks, then scattered into place
+    explicit BSRMatrix(const BasicCSRMatrix<Value, Index>& csr)
+        : BSRMatrix(csr.getDimensions().first, csr.getDimensions().second) {
+        const std::vector<Index>& rowPtr = csr.getRowPointers();
+        const std::vector<Index>& colIdx = csr.getColumnIndices();
+        const std::vector<Value>& csrValues = csr.getValues();
+        
+        const Index NO_BLOCK = std::numeric_limits<Index>::max();
+        std::vector<Index> slot(blockCols, NO_BLOCK);  // Block column -> stored block of this block row
+        std::vector<Index> touched;
+        
+        for (Index bi = 0; bi < blockRows; bi++) {
+            Index firstRow = bi * B;
+            Index lastRow = std::min<Index>(firstRow + B, rows);
+            
+            touched.clear();
+            for (Index k = rowPtr[firstRow]; k < rowPtr[lastRow]; k++) {
+                Index bc = colIdx[k] / B;
+                if (slot[bc] == NO_BLOCK) {
+                    slot[bc] = 0;
+                    touched.push_back(bc);
+                }
+            }
+            std::sort(touched.begin(), touched.end());
+            
+            Index base = (Index)blockCol.size();
+            for (size_t t = 0; t < touched.size(); t++) {
+                slot[touched[t]] = base + (Index)t;
+                blockCol.push_back(touched[t]);
+            }
+            values.resize(blockCol.size() * BLOCK_VALUES, Value(0));
+            
+            for (Index r = firstRow; r < lastRow; r++) {
+                for (Index k = rowPtr[r]; k < rowPtr[r + 1]; k++) {
+                    Index col = colIdx[k];
+                    size_t offset = (size_t)slot[col / B] * BLOCK_VALUES + (col % B) * B + (r - firstRow);
+                    values[offset] = csrValues[k];
+                }
+            }
+            
+            for (Index bc : touched) {
+                slot[bc] = NO_BLOCK;
+            }
+            blockPtr[bi + 1] = (Index)blockCol.size();
+        }
+        countNonZeros();
+    }
+    
+    // Get value at given position (binary search for the block)
+    Value get(Index row, Index col) const {
+        if (isNegativeIndex(row) || row >= rows || isNegativeIndex(col) || col >= cols) {
+            throw std::out_of_range("Index out of bounds");
+        }
+        
+        Index bi = row / B;
+        const Index* begin = blockCol.data() + blockPtr[bi];
+        const Index* end = blockCol.data() + blockPtr[bi + 1];
+        const Index* it = std::lower_bound(begin, end, col / B);
+        if (it == end || *it != col / B) {
+            return Value(0);
+        }
+        return values[(size_t)(it - blockCol.data()) * BLOCK_VALUES + (col % B) * B + row % B];
+    }
+    
+    // Sparse matrix-vector product y = A * x
+    std::vector<Value> multiply(const std::vector<Value>& x) const {
+        if (x.size() != (size_t)cols) {
+            throw std::invalid_argument("Vector length must match matrix columns");
+        }
+        
+        std::vector<Value> y(rows, Value(0));
+        multiply(x.data(), y.data());
+        return y;
+    }
+    
+    // Sparse matrix-vector product y = A * x on raw arrays, block rows shared out
+    // across threads; numThreads = 0 uses every hardware thread for large matrices
+    void multiply(const Value* x, Value* y, int numThreads = 0) const {
+        const size_t MIN_VALUES_PER_THREAD = 50000;
+        if (numThreads <= 0) {
+            numThreads = defaultThreadCount();
+        }
+        numThreads = (int)std::max<size_t>(1, std::min<size_t>(numThreads, values.size() / MIN_VALUES_PER_THREAD));
+        
+        // The partial last block column reads x through a zero-padded copy
+        Value xTail[B] = {};
+        Index tailBlock = std::numeric_limits<Index>::max();
+        if (cols % B != 0) {
+            tailBlock = blockCols - 1;
+            std::copy(x + (size_t)tailBlock * B, x + cols, xTail);
+        }
+        
+        parallelForBlocks(blockRows, 256, numThreads, [&](size_t begin, size_t end, int) {
+            Value sums[B];
+            for (Index bi = (Index)begin; bi < (Index)end; bi++) {
+                Index start = blockPtr[bi];
+                blockRowProduct<B>(blockCol.data() + start, values.data() + (size_t)start * BLOCK_VALUES,
+                                   blockPtr[bi + 1] - start, x, xTail, tailBlock, sums);
+                Index firstRow = bi * B;
+                int valid = (int)std::min<Index>(B, rows - firstRow);
+                for (int r = 0; r < valid; r++) {
+                    y[firstRow + r] = sums[r];
+                }
+            }
+        });
+    }
+    
+    // Sparse matrix-matrix product (block Gustavson): a symbolic pass counts the
+    // output blocks of every block row, then a block-row-parallel numeric pass
+    // accumulates B x B block products in a dense per-thread accumulator
+    BSRMatrix multiply(const BSRMatrix& other, int numThreads = 0) const {
+        if (cols != other.rows) {
+            throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
+        }
+        if (numThreads <= 0) {
+            numThreads = defaultThreadCount();
+        }
+        
+        const size_t BLOCK_ROWS_PER_TASK = 64;
+        const Index NO_ROW = std::numeric_limits<Index>::max();
+        Index outBlockCols = other.blockCols;
+        
+        std::vector<std::vector<Index>> markers(numThreads);
+        std::vector<std::vector<Value>> accumulators(numThreads);
+        
+        // Symbolic pass: count distinct output blocks per block row
+        std::vector<Index> resultPtr((size_t)blockRows + 1, 0);
+        parallelForBlocks(blockRows, BLOCK_ROWS_PER_TASK, numThreads, [&](size_t begin, size_t end, int t) {
+            std::vector<Index>& marker = markers[t];
+            if (marker.empty()) {
+                marker.assign(outBlockCols, NO_ROW);
+            }
+            for (Index i = (Index)begin; i < (Index)end; i++) {
+                Index count = 0;
+                for (Index k = blockPtr[i]; k < blockPtr[i + 1]; k++) {
+                    Index mid = blockCol[k];
+                    for (Index m = other.blockPtr[mid]; m < other.blockPtr[mid + 1]; m++) {
+                        Index j = other.blockCol[m];
+                        if (marker[j] != i) {
+                            marker[j] = i;
+                            count++;
+                        }
+                    }
+                }
+                resultPtr[i + 1] = count;
+            }
+        });
+        
+        for (Index i = 0; i < blockRows; i++) {
+            resultPtr[i + 1] += resultPtr[i];
+        }
+        
+        std::vector<Index> resultCols(resultPtr[blockRows]);
+        std::vector<Value> resultValues((size_t)resultPtr[blockRows] * BLOCK_VALUES);
+        
+        for (std::vector<Index>& marker : markers) {
+            std::fill(marker.begin(), marker.end(), NO_ROW);
+        }
+        
+        // Numeric pass: each block row writes into its own pre-sized slot
+        parallelForBlocks(blockRows, BLOCK_ROWS_PER_TASK, numThreads, [&](size_t begin, size_t end, int t) {
+            std::vector<Index>& marker = markers[t];
+            std::vector<Value>& accumulator = accumulators[t];
+            if (marker.empty()) {
+                marker.assign(outBlockCols, NO_ROW);
+            }
+            if (accumulator.empty()) {
+                accumulator.assign((size_t)outBlockCols * BLOCK_VALUES, Value(0));
+            }
+            
+            for (Index i = (Index)begin; i < (Index)end; i++) {
+                Index* rowCols = resultCols.data() + resultPtr[i];
+                Index count = 0;
+                for (Index k = blockPtr[i]; k < blockPtr[i + 1]; k++) {
+                    Index mid = blockCol[k];
+                    const Value* a = values.data() + (size_t)k * BLOCK_VALUES;
+                    for (Index m = other.blockPtr[mid]; m < other.blockPtr[mid + 1]; m++) {
+                        Index j = other.blockCol[m];
+                        Value* c = accumulator.data() + (size_t)j * BLOCK_VALUES;
+                        if (marker[j] != i) {
+                            marker[j] = i;
+                            rowCols[count++] = j;
+                            std::fill(c, c + BLOCK_VALUES, Value(0));
+                        }
+                        blockMultiplyAdd<B>(a, other.values.data() + (size_t)m * BLOCK_VALUES, c);
+                    }
+                }
+                
+                std::sort(rowCols, rowCols + count);
+                Value* rowValues = resultValues.data() + (size_t)resultPtr[i] * BLOCK_VALUES;
+                for (Index c = 0; c < count; c++) {
+                    const Value* block = accumulator.data() + (size_t)rowCols[c] * BLOCK_VALUES;
+                    std::copy(block, block + BLOCK_VALUES, rowValues + (size_t)c * BLOCK_VALUES);
+                }
+            }
+        });
+        
+        BSRMatrix result(rows, other.cols);
+        result.blockPtr = std::move(resultPtr);
+        result.blockCol = std::move(resultCols);
+        result.values = std::move(resultValues);
+        result.dropZeroBlocks();
+        result.countNonZeros();
+        return result;
+    }
+    
+    // Call f(row, col, value) for every non-zero in (row, col) order
+    template <typename F>
+    void forEachNonZero(F f) const {
+        for (Index bi = 0; bi < blockRows; bi++) {
+            Index firstRow = bi * B;
+            int valid = (int)std::min<Index>(B, rows - firstRow);
+            for (int r = 0; r < valid; r++) {
+                for (Index k = blockPtr[bi]; k < blockPtr[bi + 1]; k++) {
+                    const Value* block = values.data() + (size_t)k * BLOCK_VALUES;
+                    for (int c = 0; c < B; c++) {
+                        if (block[c * B + r] != Value(0)) {
+                            f(firstRow + r, blockCol[k] * B + c, block[c * B + r]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    
+    // Convert to CSR, dropping the zeros that fill out blocks
+    BasicCSRMatrix<Value, Index> toCSR() const {
+        return convertToCSR<BasicCSRMatrix<Value, Index>>(*this);
+    }
+    
+    // Get number of non-zero elements
+    Index getNonZeroCount() const {
+        return nnz;
+    }
+    
+    // Get number of stored blocks
+    Index getBlockCount() const {
+        return (Index)blockCol.size();
+    }
+    
+    // Fraction of stored block entries that are non-zero
+    double getFillRatio() const {
+        return values.empty() ? 1.0 : (double)nnz / values.size();
+    }
+    
+    // Get matrix dimensions
+    std::pair<Index, Index> getDimensions() const {
+        return std::make_pair(rows, cols);
+    }
+    
+    // Bytes of index data (block pointers and block columns)
+    size_t getIndexMemoryUsage() const {
+        return sizeof(Index) * (blockPtr.capacity() + blockCol.capacity());
+    }
+    
+    // Get memory usage (approximate)
+    size_t getMemoryUsage() const {
+        return getIndexMemoryUsage() + sizeof(Value) * values.capacity() + sizeof(*this);
+    }
+};
+
+// Block sizes BSRMatrix is instantiated with at run time
+constexpr int BSR_BLOCK_SIZES[] = {2, 3, 4, 6, 8};
+
+// Pick the BSR block size that stores a matrix (any backend) in the fewest
+// bytes, counting values, explicit zeros filling out blocks and indices.
+// Returns 1 when plain CSR is smallest. One pass over the non-zeros counts the
+// blocks of every candidate size at once.
+template <typename Matrix>
+int detectBlockSize(const Matrix& a) {
+    using Value = typename Matrix::value_type;
+    using Index = typename Matrix::index_type;
+    
+    constexpr int numSizes = sizeof(BSR_BLOCK_SIZES) / sizeof(BSR_BLOCK_SIZES[0]);
+    auto dims = a.getDimensions();
+    
+    // lastBlockRow[s][bc]: last block row that touched block column bc at size s
+    std::vector<std::vector<long long>> lastBlockRow(numSizes);
+    long long blocks[numSizes] = {};
+    for (int s = 0; s < numSizes; s++) {
+        lastBlockRow[s].assign((size_t)dims.second / BSR_BLOCK_SIZES[s] + 1, -1);
+    }
+    
+    a.forEachNonZero([&](auto row, auto col, auto) {
+        for (int s = 0; s < numSizes; s++) {
+            long long bi = (long long)row / BSR_BLOCK_SIZES[s];
+            long long& last = lastBlockRow[s][(size_t)col / BSR_BLOCK_SIZES[s]];
+            if (last != bi) {
+                last = bi;
+                blocks[s]++;
+            }
+        }
+    });
+    
+    double bestBytes = (double)a.getNonZeroCount() * (sizeof(Value) + sizeof(Index)) +
+                       (double)dims.first * sizeof(Index);
+    int best = 1;
+    for (int s = 0; s < numSizes; s++) {
+        int b = BSR_BLOCK_SIZES[s];
+        double bytes = (double)blocks[s] * (b * b * sizeof(Value) + sizeof(Index)) +
+                       (double)dims.first / b * sizeof(Index);
+        if (bytes < bestBytes) {
+            bestBytes = bytes;
+            best = b;
+        }
+    }
+    return best;
+}
+
+// Call f(integral_constant<int, B>()) with the compile-time block size equal to
+// blockSize, e.g. withBlockSize(detectBlockSize(a), [&](auto b) { BSRMatrix<b()> ... })
+template <typename F>
+void withBlockSize(int blockSize, F f) {
+    switch (blockSize) {
+        case 1: f(std::integral_constant<int, 1>()); break;
+        case 2: f(std::integral_constant<int, 2>()); break;
+        case 3: f(std::integral_constant<int, 3>()); break;
+        case 4: f(std::integral_constant<int, 4>()); break;
+        case 6: f(std::integral_constant<int, 6>()); break;
+        case 8: f(std::integral_constant<int, 8>()); break;
+        default: throw std::invalid_argument("Unsupported BSR block size");
+    }
+}
+
+// Triplet (row, col, value) used for bulk construction
+template <typename Value, typename Index>
+struct BasicTriplet {
+    Index row;
+    Index col;
+    Value value;
+};
+
+using Triplet = BasicTriplet<double, int>;
+
+// Stable LSD radix sort of triplets by (row, col) using 16-bit digits;
+// digit passes that cannot change the order (all digits zero) are skipped
+template <typename Value, typename Index>
+inline void radixSortTriplets(std::vector<BasicTriplet<Value, Index>>& triplets) {
+    using Key = std::make_unsigned_t<Index>;
+    const int RADIX_BITS = 16;
+    const int BUCKETS = 1 << RADIX_BITS;
+    const int DIGITS = (int)sizeof(Index) * 8 / RADIX_BITS;
+    
+    Key maxRow = 0;
+    Key maxCol = 0;
+    for (const auto& t : triplets) {
+        maxRow = std::max(maxRow, (Key)t.row);
+        maxCol = std::max(maxCol, (Key)t.col);
+    }
+    
+    std::vector<BasicTriplet<Value, Index>> buffer(triplets.size());
+    std::vector<size_t> counts(BUCKETS);
+    
+    // Column digits first (least significant), then row digits
+    for (int pass = 0; pass < 2 * DIGITS; pass++) {
+        bool rowDigit = pass >= DIGITS;
+        int shift = (pass % DIGITS) * RADIX_BITS;
+        Key limit = rowDigit ? maxRow : maxCol;
+        if (shift > 0 && (limit >> shift) == 0) {
+            continue;
+        }
+        
+        std::fill(counts.begin(), counts.end(), 0);
+        for (const auto& t : triplets) {
+            Key key = (Key)(rowDigit ? t.row : t.col);
+            counts[(key >> shift) & (BUCKETS - 1)]++;
+        }
+        size_t offset = 0;
+        for (int b = 0; b < BUCKETS; b++) {
+            size_t count = counts[b];
+            counts[b] = offset;
+            offset += count;
+        }
+        for (const auto& t : triplets) {
+            Key key = (Key)(rowDigit ? t.row : t.col);
+            buffer[counts[(key >> shift) & (BUCKETS - 1)]++] = t;
+        }
+        triplets.swap(buffer);
+    }
+}
+
+// BasicSparseMatrixArray class using dynamic arrays (COO sorted by row, then
+// column) for sparse matrix representation, parameterised on the value type
+// (float, double, int) and the index type (int, uint32_t, uint64_t) like
+// BasicCSRMatrix. The non-zero count uses the index type too.
+template <typename Value, typename Index>
+class BasicSparseMatrixArray {
+    static_assert(isSparseValue<Value>::value, "Value type must be float, double or int");
+    static_assert(isSparseIndex<Index>::value, "Index type must be int, uint32_t or uint64_t");
+    
+public:
+    using value_type = Value;
+    using index_type = Index;
+    using triplet_type = BasicTriplet<Value, Index>;
+    
+private:
+    Index rows;
+    Index cols;
+    Index capacity;
+    Index size; // Number of non-zero elements
+    char* storage; // One aligned block holding values, then rowIndices, then colIndices
+    Index* rowIndices;
+    Index* colIndices;
+    Value* values;
+    
+    static constexpr size_t STORAGE_ALIGNMENT = 64;
+    static constexpr Index MIN_CAPACITY = 10;
+    
+    static size_t alignUp(size_t bytes) {
+        return (bytes + STORAGE_ALIGNMENT - 1) & ~(STORAGE_ALIGNMENT - 1);
+    }
+    
+    // Point the three arrays into a fresh block sized for newCapacity elements
+    void allocateStorage(Index newCapacity) {
+        size_t valueBytes = alignUp(sizeof(Value) * (size_t)newCapacity);
+        size_t indexBytes = alignUp(sizeof(Index) * (size_t)newCapacity);
+        storage = static_cast<char*>(
+            ::operator new(valueBytes + 2 * indexBytes, std::align_val_t(STORAGE_ALIGNMENT)));
+        values = reinterpret_cast<Value*>(storage);
+        rowIndices = reinterpret_cast<Index*>(storage + valueBytes);
+        colIndices = reinterpret_cast<Index*>(storage + valueBytes + indexBytes);
+        capacity = newCapacity;
+    }
+    
+    void releaseStorage() {
+        if (storage != nullptr) {
+            ::operator delete(storage, std::align_val_t(STORAGE_ALIGNMENT));
+        }
+        storage = nullptr;
+        rowIndices = colIndices = nullptr;
+        values = nullptr;
+        capacity = 0;
+    }
+    
+    // Move the elements into a block of newCapacity (>= size) with three memcpy calls
+    void reallocate(Index newCapacity) {
+        char* oldStorage = storage;
+        Index* oldRowIndices = rowIndices;
+        Index* oldColIndices = colIndices;
+        Value* oldValues = values;
+        
+        allocateStorage(newCapacity);
+        if (size > 0) {
+            memcpy(rowIndices, oldRowIndices, sizeof(Index) * (size_t)size);
+            memcpy(colIndices, oldColIndices, sizeof(Index) * (size_t)size);
+            memcpy(values, oldValues, sizeof(Value) * (size_t)size);
+        }
+        
+        if (oldStorage != nullptr) {
+            ::operator delete(oldStorage, std::align_val_t(STORAGE_ALIGNMENT));
+        }
+    }
+    
+    // Helper function to find insertion point using binary search
+    Index findInsertionPoint(Index row, Index col) const {
+        Index left = 0;
+        Index right = size;
+        
+        while (left < right) {
+            Index mid = left + (right - left) / 2;
+            if (rowIndices[mid] < row ||
+                (rowIndices[mid] == row && colIndices[mid] < col)) {
+                left = mid + 1;
+            } else {
+                right = mid;
+            }
+        }
+        return left;
+    }
+    
+    // Helper function to find an element using binary search; on success index
+    // is its position
+    bool findElement(Index row, Index col, Index& index) const {
+        index = findInsertionPoint(row, col);
+        return index < size && rowIndices[index] == row && colIndices[index] == col;
+    }
+    
+    // Grow geometrically when capacity is exceeded
+    void resize() {
+        reallocate(std::max<Index>(capacity * 2, MIN_CAPACITY));
+    }
+    
+    // Shift elements to the right from given index
+    void shiftRight(Index index) {
+        size_t count = (size_t)(size - index);
+        memmove(rowIndices + index + 1, rowIndices + index, sizeof(Index) * count);
+        memmove(colIndices + index + 1, colIndices + index, sizeof(Index) * count);
+        memmove(values + index + 1, values + index, sizeof(Value) * count);
+    }
+    
+    // Validate, sort by (row, col) and sum duplicate triplets in place (zeros kept)
+    static void combineTriplets(Index r, Index c, std::vector<triplet_type>& triplets) {
+        for (const triplet_type& t : triplets) {
+            if (isNegativeIndex(t.row) || t.row >= r || isNegativeIndex(t.col) || t.col >= c) {
+                throw std::out_of_range("Index out of bounds");
+            }
+        }
+        
+        radixSortTriplets(triplets);
+        
+        size_t out = 0;
+        for (size_t i = 0; i < triplets.size(); i++) {
+            if (out > 0 && triplets[out - 1].row == triplets[i].row &&
+                triplets[out - 1].col == triplets[i].col) {
+                triplets[out - 1].value += triplets[i].value;
+            } else {
+                triplets[out++] = triplets[i];
+            }
+        }
+        triplets.resize(out);
+    }
+    
+    // Shift elements to the left from given index
+    void shiftLeft(Index index) {
+        size_t count = (size_t)(size - index - 1);
+        memmove(rowIndices + index, rowIndices + index + 1, sizeof(Index) * count);
+        memmove(colIndices + index, colIndices + index + 1, sizeof(Index) * count);
+        memmove(values + index, values + index + 1, sizeof(Value) * count);
+    }
+    
+public:
+    // Constructor
+    BasicSparseMatrixArray(Index r, Index c) : BasicSparseMatrixArray(r, c, MIN_CAPACITY) {}
+    
+    // Constructor with room for initialCapacity non-zeros
+    BasicSparseMatrixArray(Index r, Index c, Index initialCapacity)
+        : rows(r), cols(c), capacity(0), size(0), storage(nullptr) {
+        if (isNegativeIndex(r) || isNegativeIndex(c)) {
+            throw std::invalid_argument("Matrix dimensions must be non-negative");
+        }
+        allocateStorage(isNegativeIndex(initialCapacity) ? Index(1) : std::max<Index>(initialCapacity, 1));
+    }
+    
+    // Constructor converting from CSR storage (explicit zeros are dropped)
+    explicit BasicSparseMatrixArray(const BasicCSRMatrix<Value, Index>& csr)
+        : BasicSparseMatrixArray(csr.getDimensions().first, csr.getDimensions().second,
+                                 csr.getNonZeroCount()) {
+        const std::vector<Index>& rowPtr = csr.getRowPointers();
+        const std::vector<Index>& colIdx = csr.getColumnIndices();
+        const std::vector<Value>& vals = csr.getValues();
+        for (Index i = 0; i < rows; i++) {
+            for (Index k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+                if (vals[k] != Value(0)) {
+                    rowIndices[size] = i;
+                    colIndices[size] = colIdx[k];
+                    values[size] = vals[k];
+                    size++;
+                }
+            }
+        }
+    }
+    
+    // Constructor evaluating a lazy expression (see sparseMatrix.h) in one pass,
+    // e.g. SparseMatrixArray c = a + 2.0 * transpose(b);
+    template <typename Expr, typename = std::enable_if_t<isSparseExpression<Expr>::value>>
+    BasicSparseMatrixArray(const Expr& expr)
+        : BasicSparseMatrixArray((Index)expr.getDimensions().first, (Index)expr.getDimensions().second,
+                                 (Index)std::min(expr.getNonZeroBound(),
+                                                 expr.getDimensions().first * expr.getDimensions().second)) {
+        // The non-zero bound covers the result, so the storage never grows; a local
+        // count keeps the stores from reloading size through the index arrays
+        Index count = 0;
+        Index* rowOut = rowIndices;
+        Index* colOut = colIndices;
+        Value* valueOut = values;
+        evaluateSparseExpression(expr, [&](size_t row, size_t col, double value) {
+            rowOut[count] = (Index)row;
+            colOut[count] = (Index)col;
+            valueOut[count] = (Value)value;
+            count++;
+        });
+        size = count;
+    }
+    
+    // Destructor
+    ~BasicSparseMatrixArray() {
+        releaseStorage();
+    }
+    
+    // Copy constructor (allocates only what the elements need)
+    BasicSparseMatrixArray(const BasicSparseMatrixArray& other)
+        : rows(other.rows), cols(other.cols), capacity(0), size(other.size), storage(nullptr) {
+        allocateStorage(std::max<Index>(size, 1));
+        memcpy(rowIndices, other.rowIndices, sizeof(Index) * (size_t)size);
+        memcpy(colIndices, other.colIndices, sizeof(Index) * (size_t)size);
+        memcpy(values, other.values, sizeof(Value) * (size_t)size);
+    }
+    
+    // Move constructor (takes over the storage; other is left empty)
+    BasicSparseMatrixArray(BasicSparseMatrixArray&& other) noexcept
+        : rows(other.rows), cols(other.cols), capacity(other.capacity), size(other.size),
+          storage(other.storage), rowIndices(other.rowIndices),
+          colIndices(other.colIndices), values(other.values) {
+        other.storage = nullptr;
+        other.rowIndices = other.colIndices = nullptr;
+        other.values = nullptr;
+        other.capacity = 0;
+        other.size = 0;
+    }
+    
+    // Assignment operator (reuses the existing block when it is large enough)
+    BasicSparseMatrixArray& operator=(const BasicSparseMatrixArray& other) {
+        if (this != &other) {
+            if (capacity < other.size || storage == nullptr) {
+                releaseStorage();
+                allocateStorage(std::max<Index>(other.size, 1));
+            }
+            
+            rows = other.rows;
+            cols = other.cols;
+            size = other.size;
+            
+            memcpy(rowIndices, other.rowIndices, sizeof(Index) * (size_t)size);
+            memcpy(colIndices, other.colIndices, sizeof(Index) * (size_t)size);
+            memcpy(values, other.values, sizeof(Value) * (size_t)size);
+        }
+        return *this;
+    }
+    
+    // Move assignment operator
+    BasicSparseMatrixArray& operator=(BasicSparseMatrixArray&& other) noexcept {
+        if (this != &other) {
+            releaseStorage();
+            
+            rows = other.rows;
+            cols = other.cols;
+            capacity = other.capacity;
+            size = other.size;
+            storage = other.storage;
+            rowIndices = other.rowIndices;
+            colIndices = other.colIndices;
+            values = other.values;
+            
+            other.storage = nullptr;
+            other.rowIndices = other.colIndices = nullptr;
+            other.values = nullptr;
+            other.capacity = 0;
+            other.size = 0;
+        }
+        return *this;
+    }
+    
+    // Assign a lazy expression; it may refer to this matrix, so the result is
+    // built in fresh storage and then moved in
+    template <typename Expr, typename = std::enable_if_t<isSparseExpression<Expr>::value>>
+    BasicSparseMatrixArray& operator=(const Expr& expr) {
+        return *this = BasicSparseMatrixArray(expr);
+    }
+    
+    // Make room for at least newCapacity non-zeros
+    void reserve(Index newCapacity) {
+        if (newCapacity > capacity) {
+            reallocate(newCapacity);
+        }
+    }
+    
+    // Release unused capacity
+    void shrink_to_fit() {
+        if (capacity > std::max<Index>(size, 1)) {
+            reallocate(std::max<Index>(size, 1));
+        }
+    }
+    
+    // Insert a value at given position
+    void insert(Index row, Index col, Value value) {
+        if (isNegativeIndex(row) || row >= rows || isNegativeIndex(col) || col >= cols) {
+            throw std::out_of_range("Index out of bounds");
+        }
+        
+        // If value is zero, remove the element if it exists
+        if (value == Value(0)) {
+            remove(row, col);
+            return;
+        }
+        
+        Index index;
+        if (findElement(row, col, index)) {
+            // Element exists, update its value
+            values[index] = value;
+        } else {
+            // Element doesn't exist, insert it at its sorted position
+            if (size >= capacity) {
+                resize();
+            }
+            
+            shiftRight(index);
+            
+            rowIndices[index] = row;
+            colIndices[index] = col;
+            values[index] = value;
+            size++;
+        }
+    }
+    
+    // Build a matrix from unsorted triplets in O(n): radix sort by (row, col),
+    // sum duplicates, drop zeros and compact once into exactly sized arrays
+    static BasicSparseMatrixArray fromTriplets(Index r, Index c, std::vector<triplet_type> triplets) {
+        combineTriplets(r, c, triplets);
+        
+        BasicSparseMatrixArray result(r, c, (Index)triplets.size());
+        
+        for (const triplet_type& t : triplets) {
+            if (t.value != Value(0)) {
+                result.rowIndices[result.size] = t.row;
+                result.colIndices[result.size] = t.col;
+                result.values[result.size] = t.value;
+                result.size++;
+            }
+        }
+        
+        return result;
+    }
+    
+    // Read a coordinate Matrix Market file: entries are streamed into a triplet
+    // list and bulk-built, so the file may be in any order and contain duplicates
+    static BasicSparseMatrixArray readMatrixMarket(const std::string& filename) {
+        static_assert(std::is_same<Value, double>::value && std::is_same<Index, int>::value,
+                      "Matrix Market files are read as double values with int indices");
+        std::vector<triplet_type> triplets;
+        int r = 0, c = 0;
+        sparse_io::readMatrixMarket(filename,
+            [&](const sparse_io::MatrixMarketHeader& header) {
+                r = header.rows;
+                c = header.cols;
+                bool mirrored = header.symmetric || header.skewSymmetric;
+                triplets.reserve((size_t)header.entries * (mirrored ? 2 : 1));
+            },
+            [&](int row, int col, double value) {
+                triplets.push_back({row, col, value});
+            });
+        return fromTriplets(r, c, std::move(triplets));
+    }
+    
+    // Write as a general coordinate Matrix Market file
+    void writeMatrixMarket(const std::string& filename) const {
+        static_assert(std::is_same<Value, double>::value && std::is_same<Index, int>::value,
+                      "Matrix Market files are written from double values with int indices");
+        sparse_io::MatrixMarketWriter writer(filename, rows, cols, size);
+        for (int i = 0; i < size; i++) {
+            writer.write(rowIndices[i], colIndices[i], values[i]);
+        }
+        writer.close();
+    }
+    
+    // Write in the binary CSR format (see sparse_io.h)
+    void writeBinary(const std::string& filename) const {
+        static_assert(std::is_same<Value, double>::value && std::is_same<Index, int>::value,
+                      "Binary CSR files hold double values with int indices");
+        std::vector<int> rowPtr(rows + 1, 0);
+        for (int i = 0; i < size; i++) {
+            rowPtr[rowIndices[i] + 1]++;
+        }
+        for (int i = 0; i < rows; i++) {
+            rowPtr[i + 1] += rowPtr[i];
+        }
+        sparse_io::writeBinaryCSR(filename, rows, cols, rowPtr.data(), colIndices, values);
+    }
+    
+    // Load a binary CSR file (validated by MappedCSRFile) through mmap straight
+    // into the COO arrays
+    static BasicSparseMatrixArray readBinary(const std::string& filename) {
+        static_assert(std::is_same<Value, double>::value && std::is_same<Index, int>::value,
+                      "Binary CSR files hold double values with int indices");
+        sparse_io::MappedCSRFile file(filename);
+        const int* rowPtr = file.getRowPointers();
+        const int* colIdx = file.getColumnIndices();
+        int nnz = file.getNonZeroCount();
+        
+        BasicSparseMatrixArray result(file.getRows(), file.getCols(), nnz);
+        for (int i = 0; i < result.rows; i++) {
+            for (int k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+                result.rowIndices[k] = i;
+            }
+        }
+        memcpy(result.colIndices, colIdx, sizeof(int) * nnz);
+        memcpy(result.values, file.getValues(), sizeof(double) * nnz);
+        result.size = nnz;
+        return result;
+    }
+    
+    // Insert a batch of triplets in O(nnz + n): duplicates within the batch are
+    // summed, then each batch entry overwrites (or, if zero, removes) the existing
+    // element like insert() does
+    void insertBatch(std::vector<triplet_type> triplets) {
+        combineTriplets(rows, cols, triplets);
+        
+        Index batchSize = (Index)triplets.size();
+        BasicSparseMatrixArray merged(rows, cols, size + batchSize);
+        Index* newRowIndices = merged.rowIndices;
+        Index* newColIndices = merged.colIndices;
+        Value* newValues = merged.values;
+        
+        Index i = 0, j = 0, k = 0;
+        while (i < size || j < batchSize) {
+            bool takeBatch;
+            if (i == size) {
+                takeBatch = true;
+            } else if (j == batchSize) {
+                takeBatch = false;
+            } else if (rowIndices[i] != triplets[j].row) {
+                takeBatch = triplets[j].row < rowIndices[i];
+            } else {
+                takeBatch = triplets[j].col <= colIndices[i];
+                if (triplets[j].col == colIndices[i]) {
+                    i++; // Batch value replaces the existing one
+                }
+            }
+            
+            if (takeBatch) {
+                if (triplets[j].value != Value(0)) {
+                    newRowIndices[k] = triplets[j].row;
+                    newColIndices[k] = triplets[j].col;
+                    newValues[k] = triplets[j].value;
+                    k++;
+                }
+                j++;
+            } else {
+                newRowIndices[k] = rowIndices[i];
+                newColIndices[k] = colIndices[i];
+                newValues[k] = values[i];
+                i++;
+                k++;
+            }
+        }
+        
+        merged.size = k;
+        *this = std::move(merged);
+    }
+    
+    // Get value at given position
+    Value get(Index row, Index col) const {
+        if (isNegativeIndex(row) || row >= rows || isNegativeIndex(col) || col >= cols) {
+            throw std::out_of_range("Index out of bounds");
+        }
+        
+        Index index;
+        return findElement(row, col, index) ? values[index] : Value(0);
+    }
+    
+    // Set value at given position (alias for insert)
+    void set(Index row, Index col, Value value) {
+        insert(row, col, value);
+    }
+    
+    // Remove element at given position
+    void remove(Index row, Index col) {
+        Index index;
+        if (findElement(row, col, index)) {
+            shiftLeft(index);
+            size--;
+        }
+    }
+    
+    // Add two sparse matrices
+    BasicSparseMatrixArray add(const BasicSparseMatrixArray& other) const {
+        return axpby(Value(1), Value(1), other);
+    }
+    
+    // Compute alpha * this + beta * other in one two-pointer merge over the
+    // (row, col)-sorted arrays, writing straight into pre-sized storage
+    BasicSparseMatrixArray axpby(Value alpha, Value beta, const BasicSparseMatrixArray& other) const {
+        if (rows != other.rows || cols != other.cols) {
+            throw std::invalid_argument("Matrix dimensions must match for addition");
+        }
+        
+        BasicSparseMatrixArray result(rows, cols, size + other.size);
+        
+        Index i = 0, j = 0;
+        Index k = 0;
+        while (i < size || j < other.size) {
+            Index row, col;
+            Value value;
+            if (j == other.size || (i < size &&
+                (rowIndices[i] < other.rowIndices[j] ||
+                 (rowIndices[i] == other.rowIndices[j] && colIndices[i] < other.colIndices[j])))) {
+                row = rowIndices[i];
+                col = colIndices[i];
+                value = alpha * values[i];
+                i++;
+            } else if (i == size || rowIndices[i] != other.rowIndices[j] ||
+                       colIndices[i] != other.colIndices[j]) {
+                row = other.rowIndices[j];
+                col = other.colIndices[j];
+                value = beta * other.values[j];
+                j++;
+            } else {
+                row = rowIndices[i];
+                col = colIndices[i];
+                value = alpha * values[i] + beta * other.values[j];
+                i++;
+                j++;
+            }
+            
+            if (value != Value(0)) {
+                result.rowIndices[k] = row;
+                result.colIndices[k] = col;
+                result.values[k] = value;
+                k++;
+            }
+        }
+        result.size = k;
+        
+        return result;
+    }
+    
+    // Multiply two sparse matrices
+    BasicSparseMatrixArray multiply(const BasicSparseMatrixArray& other) const {
+        if (cols != other.rows) {
+            throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
+        }
+        
+        // Row-wise Gustavson product on the CSR forms of both operands
+        return BasicSparseMatrixArray(toCSR().multiply(other.toCSR()));
+    }
+    
+    // Sparse matrix-vector product y = A * x (x has cols entries, y has rows
+    // entries) in one pass over the row-sorted arrays; for repeated products
+    // convert once with toCSR() and use its threaded SIMD kernel
+    void multiply(const Value* x, Value* y) const {
+        std::fill(y, y + rows, Value(0));
+        Index k = 0;
+        while (k < size) {
+            Index row = rowIndices[k];
+            Index end = k;
+            while (end < size && rowIndices[end] == row) {
+                end++;
+            }
+            y[row] = sparseRowDot(colIndices + k, values + k, (size_t)(end - k), x);
+            k = end;
+        }
+    }
+    
+    // Sparse x dense product with B (cols x k, row-major); converts to CSR once per
+    // call, so for repeated products convert with toCSR() and use multiplyDense there
+    std::vector<Value> multiplyDense(const std::vector<Value>& b, size_t k, int numThreads = 0) const {
+        return toCSR().multiplyDense(b, k, numThreads);
+    }
+    
+    // Transpose the matrix
+    BasicSparseMatrixArray transpose() const {
+        return BasicSparseMatrixArray(transposeCSR());
+    }
+    
+    // Transpose straight into CSR form by counting sort in O(nnz + cols);
+    // numThreads > 1 splits the non-zeros into chunks counted and scattered in parallel
+    BasicCSRMatrix<Value, Index> transposeCSR(int numThreads = 1) const {
+        if (numThreads <= 0) {
+            numThreads = defaultThreadCount();
+        }
+        size_t nnz = (size_t)size;
+        int numChunks = (int)std::max<size_t>(1, std::min<size_t>(numThreads, nnz));
+        
+        std::vector<Index> resultPtr, resultIdx;
+        std::vector<Value> resultValues;
+        countingSortTranspose<Value, Index>(cols, nnz, numChunks, numThreads,
+            [&](size_t chunk, auto emit) {
+                size_t begin = nnz / numChunks * chunk + std::min(chunk, nnz % numChunks);
+                size_t end = nnz / numChunks * (chunk + 1) + std::min(chunk + 1, nnz % numChunks);
+                for (size_t k = begin; k < end; k++) {
+                    emit(rowIndices[k], colIndices[k], values[k]);
+                }
+            }, resultPtr, resultIdx, resultValues);
+        
+        return BasicCSRMatrix<Value, Index>(cols, rows, std::move(resultPtr), std::move(resultIdx),
+                                            std::move(resultValues));
+    }
+    
+    // Convert to CSR storage in O(nnz + rows); elements are already sorted by (row, col)
+    BasicCSRMatrix<Value, Index> toCSR() const {
+        std::vector<Index> rowPtr((size_t)rows + 1, 0);
+        for (Index i = 0; i < size; i++) {
+            rowPtr[rowIndices[i] + 1]++;
+        }
+        for (Index i = 0; i < rows; i++) {
+            rowPtr[i + 1] += rowPtr[i];
+        }
+        
+        std::vector<Index> colIdx(colIndices, colIndices + size);
+        std::vector<Value> vals(values, values + size);
+        return BasicCSRMatrix<Value, Index>(rows, cols, std::move(rowPtr), std::move(colIdx),
+                                            std::move(vals));
+    }
+    
+    // Display the matrix
+    void display() const {
+        std::cout << "Sparse Matrix (" << rows << "x" << cols << "):" << std::endl;
+        for (Index i = 0; i < rows; i++) {
+            for (Index j = 0; j < cols; j++) {
+                std::cout << get(i, j) << "\t";
+            }
+            std::cout << std::endl;
+        }
+        std::cout << std::endl;
+    }
+    
+    // Call f(row, col, value) for every non-zero in (row, col) order
+    template <typename F>
+    void forEachNonZero(F f) const {
+        for (Index i = 0; i < size; i++) {
+            f(rowIndices[i], colIndices[i], values[i]);
+        }
+    }
+    
+    // Call f(col, value) for the non-zeros of one row in column order (the row
+    // is found by binary search)
+    template <typename F>
+    void forEachInRow(Index row, F f) const {
+        Index k = (Index)(std::lower_bound(rowIndices, rowIndices + size, row) - rowIndices);
+        for (; k < size && rowIndices[k] == row; k++) {
+            f(colIndices[k], values[k]);
+        }
+    }
+    
+    // Same, continuing from position instead of searching: reading rows in
+    // increasing order with one position (starting at 0) walks the arrays once
+    template <typename F>
+    void forEachInRow(Index row, size_t& position, F f) const {
+        size_t k = position;
+        while (k < (size_t)size && rowIndices[k] < row) {
+            k++;
+        }
+        for (; k < (size_t)size && rowIndices[k] == row; k++) {
+            f(colIndices[k], values[k]);
+        }
+        position = k;
+    }
+    
+    // Display only non-zero elements
+    void displaySparse() const {
+        std::cout << "Non-zero elements:" << std::endl;
+        for (Index i = 0; i < size; i++) {
+            std::cout << "(" << rowIndices[i] << ", " << colIndices[i] << ") = "
+                 << values[i] << std::endl;
+        }
+        std::cout << std::endl;
+    }
+    
+    // Get number of non-zero elements
+    Index getNonZeroCount() const {
+        return size;
+    }
+    
+    // Check if matrix is empty (all zeros)
+    bool isEmpty() const {
+        return size == 0;
+    }
+    
+    // Clear all elements
+    void clear() {
+        size = 0;
+    }
+    
+    // Get matrix dimensions
+    std::pair<Index, Index> getDimensions() const {
+        return std::make_pair(rows, cols);
+    }
+    
+    // Get memory usage (approximate)
+    size_t getMemoryUsage() const {
+        return alignUp(sizeof(Value) * (size_t)capacity) + 2 * alignUp(sizeof(Index) * (size_t)capacity)
+               + sizeof(*this);
+    }
+    
+    // Get capacity
+    Index getCapacity() const {
+        return capacity;
+    }
+    
+    // Get efficiency ratio (non-zero elements / capacity)
+    double getEfficiency() const {
+        return (capacity > 0) ? (double)size / capacity : 0.0;
+    }
+};
+
+// The original double-valued, int-indexed COO arrays
+using SparseMatrixArray = BasicSparseMatrixArray<double, int>;
+
+// ConcurrentSparseBuilder collects non-zeros from many threads at once: each
+// slot owns a private COO buffer, so insert() is a plain append with no locks or
+// atomics as long as every slot is used by one thread at a time (e.g. the
+// threadId of parallelForBlocks). finalize() turns the buffers into CSR with a
+// parallel counting sort by row, then sorts and sums duplicates row by row.
+class ConcurrentSparseBuilder {
+private:
+    // Fixed-size chunks, so a growing buffer never copies what it already holds;
+    // cache-line aligned so appends from neighbouring slots do not false-share
+    static const size_t CHUNK_SIZE = 1 << 16;
+    struct alignas(64) SlotBuffer {
+        std::vector<std::vector<Triplet>> chunks;
+        size_t count = 0;
+    };
+    
+    int rows;
+    int cols;
+    std::vector<SlotBuffer> slots;
+    
+public:
+    // Builder for a rows x cols matrix with numSlots buffers (0 = one per hardware thread)
+    ConcurrentSparseBuilder(int r, int c, int numSlots = 0) : rows(r), cols(c) {
+        if (r < 0 || c < 0) {
+            throw std::invalid_argument("Matrix dimensions must be non-negative");
+        }
+        slots.resize(numSlots > 0 ? numSlots : defaultThreadCount());
+    }
+    
+    // Append a non-zero to a slot's buffer; duplicates are summed by finalize()
+    void insert(int slot, int row, int col, double value) {
+        if (slot < 0 || slot >= (int)slots.size()) {
+            throw std::out_of_range("Builder slot out of range");
+        }
+        if (row < 0 || row >= rows || col < 0 || col >= cols) {
+            throw std::out_of_range("Index out of bounds");
+        }
+        SlotBuffer& buffer = slots[slot];
+        if (buffer.chunks.empty() || buffer.chunks.back().size() == CHUNK_SIZE) {
+            buffer.chunks.emplace_back();
+            buffer.chunks.back().reserve(CHUNK_SIZE);
+        }
+        buffer.chunks.back().push_back({row, col, value});
+        buffer.count++;
+    }
+    
+    // Build the CSR matrix from everything inserted so far, summing duplicates and
+    // dropping zero sums, then empty the buffers. Not safe to call while other
+    // threads are still inserting.
+    CSRMatrix finalize(int numThreads = 0) {
+        if (numThreads <= 0) {
+            numThreads = defaultThreadCount();
+        }
+        size_t total = 0;
+        for (const SlotBuffer& slot : slots) {
+            total += slot.count;
+        }
+        if (total > (size_t)std::numeric_limits<int>::max()) {
+            throw std::out_of_range("Too many non-zeros for a CSRMatrix");
+        }
+        
+        // Bucket by row: each chunk scatters a contiguous group of slots, so the
+        // histograms cost numChunks * rows whatever the slot count
+        int numSlots = (int)slots.size();
+        int numChunks = std::max(1, std::min(numThreads, numSlots));
+        std::vector<int> rowPtr, colIdx;
+        std::vector<double> vals;
+        countingSortTranspose(rows, total, numChunks, numThreads,
+            [&](int chunk, auto emit) {
+                int begin = (int)((long long)numSlots * chunk / numChunks);
+                int end = (int)((long long)numSlots * (chunk + 1) / numChunks);
+                for (int s = begin; s < end; s++) {
+                    for (const std::vector<Triplet>& triplets : slots[s].chunks) {
+                        for (const Triplet& t : triplets) {
+                            emit(t.col, t.row, t.value);
+                        }
+                    }
+                }
+            }, rowPtr, colIdx, vals);
+        slots.assign(numSlots, SlotBuffer());
+        
+        // Sort each row by column and sum duplicates in place, recording the new length
+        std::vector<int> rowCount(rows);
+        parallelForBlocks(rows, 1024, numThreads, [&](size_t begin, size_t end, int) {
+            std::vector<std::pair<int, double>> row;
+            for (size_t i = begin; i < end; i++) {
+                int start = rowPtr[i];
+                row.clear();
+                for (int k = start; k < rowPtr[i + 1]; k++) {
+                    row.push_back({colIdx[k], vals[k]});
+                }
+                std::sort(row.begin(), row.end(), [](const std::pair<int, double>& a, const std::pair<int, double>& b) {
+                    return a.first < b.first;
+                });
+                
+                int out = start;
+                for (size_t k = 0; k < row.size(); k++) {
+                    double sum = row[k].second;
+                    while (k + 1 < row.size() && row[k + 1].first == row[k].first) {
+                        sum += row[++k].second;
+                    }
+                    if (sum != 0.0) {
+                        colIdx[out] = row[k].first;
+                        vals[out] = sum;
+                        out++;
+                    }
+                }
+                rowCount[i] = out - start;
+            }
+        });
+        
+        // Compact the rows into the final arrays
+        std::vector<int> resultPtr(rows + 1, 0);
+        for (int i = 0; i < rows; i++) {
+            resultPtr[i + 1] = resultPtr[i] + rowCount[i];
+        }
+        if (resultPtr[rows] == (int)total) {
+            return CSRMatrix(rows, cols, std::move(resultPtr), std::move(colIdx), std::move(vals));
+        }
+        std::vector<int> resultIdx(resultPtr[rows]);
+        std::vector<double> resultValues(resultPtr[rows]);
+        parallelForBlocks(rows, 4096, numThreads, [&](size_t begin, size_t end, int) {
+            for (size_t i = begin; i < end; i++) {
+                std::copy(colIdx.begin() + rowPtr[i], colIdx.begin() + rowPtr[i] + rowCount[i],
+                          resultIdx.begin() + resultPtr[i]);
+                std::copy(vals.begin() + rowPtr[i], vals.begin() + rowPtr[i] + rowCount[i],
+                          resultValues.begin() + resultPtr[i]);
+            }
+        });
+        return CSRMatrix(rows, cols, std::move(resultPtr), std::move(resultIdx), std::move(resultValues));
+    }
+    
+    // Number of insert slots
+    int getSlotCount() const {
+        return (int)slots.size();
+    }
+    
+    // Non-zeros buffered so far, duplicates included
+    size_t getBufferedCount() const {
+        size_t total = 0;
+        for (const SlotBuffer& slot : slots) {
+            total += slot.count;
+        }
+        return total;
+    }
+};
+
+// Test matrix generators for benchmarks
+
+// Uniformly random matrix with about nnzPerRow entries per row
+inline SparseMatrixArray randomSparseMatrix(int rows, int cols, int nnzPerRow, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> pickCol(0, cols - 1);
+    std::uniform_real_distribution<double> pickValue(-1.0, 1.0);
+    
+    std::vector<Triplet> triplets;
+    triplets.reserve((size_t)rows * nnzPerRow);
+    for (int i = 0; i < rows; i++) {
+        for (int k = 0; k < nnzPerRow; k++) {
+            triplets.push_back({i, pickCol(rng), pickValue(rng)});
+        }
+    }
+    return SparseMatrixArray::fromTriplets(rows, cols, std::move(triplets));
+}
+
+// Square matrix with power-law row lengths (a few very long rows, many short ones)
+inline SparseMatrixArray powerLawSparseMatrix(int n, int avgNnzPerRow, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> pickCol(0, n - 1);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    
+    std::vector<Triplet> triplets;
+    triplets.reserve((size_t)n * avgNnzPerRow);
+    for (int i = 0; i < n; i++) {
+        // Pareto(alpha = 2) lengths have mean 2 * minimum
+        double length = (avgNnzPerRow / 2.0) / std::sqrt(1.0 - unit(rng));
+        int count = std::min((int)length, n);
+        for (int k = 0; k < count; k++) {
+            triplets.push_back({i, pickCol(rng), unit(rng)});
+        }
+    }
+    return SparseMatrixArray::fromTriplets(n, n, std::move(triplets));
+}
+
+// 5-point Laplacian on a gridSize x gridSize grid (symmetric positive definite)
+inline SparseMatrixArray poissonMatrix2D(int gridSize) {
+    int n = gridSize * gridSize;
+    std::vector<Triplet> triplets;
+    triplets.reserve((size_t)n * 5);
+    for (int r = 0; r < gridSize; r++) {
+        for (int c = 0; c < gridSize; c++) {
+            int i = r * gridSize + c;
+            triplets.push_back({i, i, 4.0});
+            if (r > 0) triplets.push_back({i, i - gridSize, -1.0});
+            if (r + 1 < gridSize) triplets.push_back({i, i + gridSize, -1.0});
+            if (c > 0) triplets.push_back({i, i - 1, -1.0});
+            if (c + 1 < gridSize) triplets.push_back({i, i + 1, -1.0});
+        }
+    }
+    return SparseMatrixArray::fromTriplets(n, n, std::move(triplets));
+}
+
+// Upwind 5-point convection-diffusion operator on a gridSize x gridSize grid with
+// flow in +x at the given cell Peclet number: non-symmetric, diagonally dominant
+inline SparseMatrixArray convectionDiffusionMatrix2D(int gridSize, double peclet) {
+    int n = gridSize * gridSize;
+    std::vector<Triplet> triplets;
+    triplets.reserve((size_t)n * 5);
+    for (int r = 0; r < gridSize; r++) {
+        for (int c = 0; c < gridSize; c++) {
+            int i = r * gridSize + c;
+            triplets.push_back({i, i, 4.0 + peclet});
+            if (r > 0) triplets.push_back({i, i - gridSize, -1.0});
+            if (r + 1 < gridSize) triplets.push_back({i, i + gridSize, -1.0});
+            if (c > 0) triplets.push_back({i, i - 1, -1.0 - peclet});
+            if (c + 1 < gridSize) triplets.push_back({i, i + 1, -1.0});
+        }
+    }
+    return SparseMatrixArray::fromTriplets(n, n, std::move(triplets));
+}
+
+// 2D Laplacian with blockSize unknowns per grid point, as in vector-valued FEM
+// problems: every coupling is a dense blockSize x blockSize block (the Kronecker
+// product of the 5-point Laplacian with 1.5 I + 0.5, so still positive definite)
+inline SparseMatrixArray blockPoissonMatrix2D(int gridSize, int blockSize) {
+    int points = gridSize * gridSize;
+    int n = points * blockSize;
+    std::vector<Triplet> triplets;
+    triplets.reserve((size_t)points * 5 * blockSize * blockSize);
+    
+    auto addBlock = [&](int p, int q, double scale) {
+        for (int r = 0; r < blockSize; r++) {
+            for (int c = 0; c < blockSize; c++) {
+                double coupling = (r == c ? 2.0 : 0.5);
+                triplets.push_back({p * blockSize + r, q * blockSize + c, scale * coupling});
+            }
+        }
+    };
+    for (int r = 0; r < gridSize; r++) {
+        for (int c = 0; c < gridSize; c++) {
+            int p = r * gridSize + c;
+            addBlock(p, p, 4.0);
+            if (r > 0) addBlock(p, p - gridSize, -1.0);
+            if (r + 1 < gridSize) addBlock(p, p + gridSize, -1.0);
+            if (c > 0) addBlock(p, p - 1, -1.0);
+            if (c + 1 < gridSize) addBlock(p, p + 1, -1.0);
+        }
+    }
+    return SparseMatrixArray::fromTriplets(n, n, std::move(triplets));
+}
+
+#endif // ARRAY_IMPLEMENTATION_H
@@ -7,6 +7,13 @@
 #include <map>
 #include <string>
 #include <queue>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
 
 using namespace std;
 
@@ -20,12 +27,13 @@ struct Edge {
 class Graph {
 private:
     int numVertices;
+    long long numArcs;
     vector<vector<Edge>> adjacencyList;
     map<string, int> nodeToIndex;
     vector<string> indexToNode;
     
 public:
-    Graph() : numVertices(0) {}
+    Graph() : numVertices(0), numArcs(0) {}
     
     void addVertex(const string& name) {
         if (nodeToIndex.find(name) == nodeToIndex.end()) {
@@ -35,6 +43,24 @@ public:
         }
     }
     
+    // Add `count` vertices named by their 1-based index (as in DIMACS files)
+    // and return the index of the first one
+    int addVertices(int count) {
+        int first = numVertices;
+        indexToNode.reserve(numVertices + count);
+        for (int i = 0; i < count; i++) {
+            string name = to_string(numVertices + 1);
+            if (nodeToIndex.find(name) != nodeToIndex.end()) {
+                throw invalid_argument("Vertex '" + name + "' already exists in graph");
+            }
+            nodeToIndex[name] = numVertices;
+            indexToNode.push_back(name);
+            adjacencyList.emplace_back();
+            numVertices++;
+        }
+        return first;
+    }
+    
     void addEdge(const string& from, const string& to, double weight) {
         addVertex(from);
         addVertex(to);
@@ -42,14 +68,33 @@ public:
         int fromIndex = nodeToIndex[from];
         int toIndex = nodeToIndex[to];
         
+        addEdge(fromIndex, toIndex, weight);
+    }
+    
+    // Add an undirected edge between two existing vertices
+    void addEdge(int fromIndex, int toIndex, double weight) {
+        addArc(fromIndex, toIndex, weight);
+        addArc(toIndex, fromIndex, weight);
+    }
+    
+    // Add a directed edge between two existing vertices
+    void addArc(int fromIndex, int toIndex, double weight) {
+        if (fromIndex < 0 || fromIndex >= numVertices || toIndex < 0 || toIndex >= numVertices) {
+            throw out_of_range("Vertex index out of bounds");
+        }
         adjacencyList[fromIndex].push_back(Edge(toIndex, weight));
-        adjacencyList[toIndex].push_back(Edge(fromIndex, weight));
+        numArcs++;
     }
     
     int getNumVertices() const {
         return numVertices;
     }
     
+    // Number of directed arcs (an undirected edge counts twice)
+    long long getNumArcs() const {
+        return numArcs;
+    }
+    
     string getVertexName(int index) const {
         if (index >= 0 && index < numVertices) {
             return indexToNode[index];
@@ -87,35 +132,41 @@ public:
         }
         cout << endl;
     }
+    
+    // Get memory usage in bytes (approximate, includes vertex names)
+    size_t getMemoryUsage() const {
+        size_t bytes = sizeof(*this);
+        bytes += adjacencyList.capacity() * sizeof(vector<Edge>);
+        for (const vector<Edge>& edges : adjacencyList) {
+            bytes += edges.capacity() * sizeof(Edge);
+        }
+        for (const string& name : indexToNode) {
+            bytes += sizeof(string) + (name.size() > 15 ? name.capacity() : 0);
+        }
+        // Red-black tree node: three pointers, colour and the key/value pair
+        bytes += nodeToIndex.size() * (4 * sizeof(void*) + sizeof(pair<const string, int>));
+        return bytes;
+    }
 };
  
 class DijkstraAlgorithm {
 private:
     const Graph* graph;
     
-public:
-    DijkstraAlgorithm(const Graph* g) : graph(g) {}
+    // Statistics of the most recent search
+    int lastSettledCount;
+    size_t lastPeakQueueSize;
     
-    pair<double, vector<string>> findShortestPath(const string& source, const string& destination) {
-        int sourceIndex = graph->getVertexIndex(source);
-        int destIndex = graph->getVertexIndex(destination);
-        
-        if (sourceIndex == -1) {
-            throw invalid_argument("Source vertex '" + source + "' not found in graph");
-        }
-        if (destIndex == -1) {
-            throw invalid_argument("Destination vertex '" + destination + "' not found in graph");
-        }
-        if (sourceIndex == destIndex) {
-            return {0.0, {source}};
-        }
-        
+    // Core search from sourceIndex; stops once destIndex is settled (-1 searches the whole graph)
+    void search(int sourceIndex, int destIndex, vector<double>& distances, vector<int>& parent) {
         int numVertices = graph->getNumVertices();
         
-        vector<double> distances(numVertices, numeric_limits<double>::max());
-        vector<int> parent(numVertices, -1);
+        distances.assign(numVertices, numeric_limits<double>::max());
+        parent.assign(numVertices, -1);
         
         distances[sourceIndex] = 0.0;
+        lastSettledCount = 0;
+        lastPeakQueueSize = 1;
         
         priority_queue<pair<double, int>, vector<pair<double, int>>, greater<pair<double, int>>> pq;
         pq.push({0.0, sourceIndex});
@@ -129,6 +180,8 @@ public:
                 continue;
             }
             
+            lastSettledCount++;
+            
             if (currentVertex == destIndex) {
                 break;
             }
@@ -143,8 +196,40 @@ public:
                     pq.push({newDist, neighbor});
                 }
             }
+            
+            lastPeakQueueSize = max(lastPeakQueueSize, pq.size());
+        }
+    }
+    
+    void checkIndex(int index) const {
+        if (index < 0 || index >= graph->getNumVertices()) {
+            throw out_of_range("Vertex index out of bounds");
+        }
+    }
+    
+public:
+    DijkstraAlgorithm(const Graph* g) : graph(g), lastSettledCount(0), lastPeakQueueSize(0) {}
+    
+    pair<double, vector<string>> findShortestPath(const string& source, const string& destination) {
+        int sourceIndex = graph->getVertexIndex(source);
+        int destIndex = graph->getVertexIndex(destination);
+        
+        if (sourceIndex == -1) {
+            throw invalid_argument("Source vertex '" + source + "' not found in graph");
+        }
+        if (destIndex == -1) {
+            throw invalid_argument("Destination vertex '" + destination + "' not found in graph");
+        }
+        if (sourceIndex == destIndex) {
+            lastSettledCount = 1;
+            lastPeakQueueSize = 1;
+            return {0.0, {source}};
         }
         
+        vector<double> distances;
+        vector<int> parent;
+        search(sourceIndex, destIndex, distances, parent);
+        
         if (distances[destIndex] == numeric_limits<double>::max()) {
             return {-1.0, {}};
         }
@@ -167,37 +252,306 @@ public:
             throw invalid_argument("Source vertex '" + source + "' not found in graph");
         }
         
-        int numVertices = graph->getNumVertices();
-        vector<double> distances(numVertices, numeric_limits<double>::max());
+        return findShortestDistances(sourceIndex);
+    }
+    
+    // Index-based point-to-point query; returns -1.0 if destination is unreachable
+    double findShortestDistance(int sourceIndex, int destIndex) {
+        checkIndex(sourceIndex);
+        checkIndex(destIndex);
         
-        distances[sourceIndex] = 0.0;
+        vector<double> distances;
+        vector<int> parent;
+        search(sourceIndex, destIndex, distances, parent);
         
-        priority_queue<pair<double, int>, vector<pair<double, int>>, greater<pair<double, int>>> pq;
-        pq.push({0.0, sourceIndex});
+        if (distances[destIndex] == numeric_limits<double>::max()) {
+            return -1.0;
+        }
+        return distances[destIndex];
+    }
+    
+    // Index-based one-to-all query
+    vector<double> findShortestDistances(int sourceIndex) {
+        checkIndex(sourceIndex);
         
-        while (!pq.empty()) {
-            double currentDist = pq.top().first;
-            int currentVertex = pq.top().second;
-            pq.pop();
-            
-            if (currentDist > distances[currentVertex]) {
-                continue;
+        vector<double> distances;
+        vector<int> parent;
+        search(sourceIndex, -1, distances, parent);
+        return distances;
+    }
+    
+    // Number of vertices settled by the most recent query
+    int getLastSettledCount() const {
+        return lastSettledCount;
+    }
+    
+    // Working memory of the most recent query in bytes (distance/parent arrays and peak heap)
+    size_t getLastWorkingMemory() const {
+        size_t numVertices = graph->getNumVertices();
+        return numVertices * (sizeof(double) + sizeof(int)) 
+             + lastPeakQueueSize * sizeof(pair<double, int>);
+    }
+};
+
+// Synthetic graph generators for benchmarking
+
+// Road-like grid: 4-neighbour lattice with random travel times, and faster
+// "highways" along every 16th row and column
+Graph createGridGraph(int gridRows, int gridCols, unsigned seed) {
+    if (gridRows <= 0 || gridCols <= 0) {
+        throw invalid_argument("Grid dimensions must be positive");
+    }
+    
+    Graph graph;
+    graph.addVertices(gridRows * gridCols);
+    
+    mt19937 rng(seed);
+    uniform_real_distribution<double> travelTime(1.0, 10.0);
+    
+    for (int r = 0; r < gridRows; r++) {
+        for (int c = 0; c < gridCols; c++) {
+            int v = r * gridCols + c;
+            if (c + 1 < gridCols) {
+                double factor = (r % 16 == 0) ? 0.3 : 1.0;
+                graph.addEdge(v, v + 1, travelTime(rng) * factor);
             }
-            
-            for (const Edge& edge : graph->getNeighbors(currentVertex)) {
-                int neighbor = edge.destination;
-                double newDist = currentDist + edge.weight;
-                
-                if (newDist < distances[neighbor]) {
-                    distances[neighbor] = newDist;
-                    pq.push({newDist, neighbor});
+            if (r + 1 < gridRows) {
+                double factor = (c % 16 == 0) ? 0.3 : 1.0;
+                graph.addEdge(v, v + gridCols, travelTime(rng) * factor);
+            }
+        }
+    }
+    
+    return graph;
+}
+
+// Random geometric graph: points in the unit square joined when closer than
+// a radius chosen to give the requested average degree; weight = distance
+Graph createRandomGeometricGraph(int numVertices, double averageDegree, unsigned seed) {
+    if (numVertices <= 0) {
+        throw invalid_argument("Number of vertices must be positive");
+    }
+    if (!(averageDegree > 0)) {
+        throw invalid_argument("Average degree must be positive");
+    }
+    
+    Graph graph;
+    graph.addVertices(numVertices);
+    
+    mt19937 rng(seed);
+    uniform_real_distribution<double> coord(0.0, 1.0);
+    
+    vector<double> xs(numVertices), ys(numVertices);
+    for (int i = 0; i < numVertices; i++) {
+        xs[i] = coord(rng);
+        ys[i] = coord(rng);
+    }
+    
+    double radius = sqrt(averageDegree / (M_PI * numVertices));
+    int cellsPerSide = max(1, min(static_cast<int>(1.0 / radius), 4096));
+    
+    // Bucket points into cells of side >= radius so only neighbouring cells are compared
+    vector<vector<int>> cells(cellsPerSide * cellsPerSide);
+    auto cellOf = [&](double v) {
+        return min(static_cast<int>(v * cellsPerSide), cellsPerSide - 1);
+    };
+    for (int i = 0; i < numVertices; i++) {
+        cells[cellOf(ys[i]) * cellsPerSide + cellOf(xs[i])].push_back(i);
+    }
+    
+    double radiusSquared = radius * radius;
+    for (int i = 0; i < numVertices; i++) {
+        int cx = cellOf(xs[i]);
+        int cy = cellOf(ys[i]);
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                int nx = cx + dx;
+                int ny = cy + dy;
+                if (nx < 0 || ny < 0 || nx >= cellsPerSide || ny >= cellsPerSide) {
+                    continue;
                 }
+                for (int j : cells[ny * cellsPerSide + nx]) {
+                    if (j <= i) continue;
+                    double ddx = xs[i] - xs[j];
+                    double ddy = ys[i] - ys[j];
+                    double d2 = ddx * ddx + ddy * ddy;
+                    if (d2 <= radiusSquared) {
+                        graph.addEdge(i, j, sqrt(d2));
+                    }
+                }
+            }
+        }
+    }
+    
+    return graph;
+}
+
+// R-MAT power-law graph with 2^scale vertices and edgeFactor * 2^scale edges
+// (Graph500 quadrant probabilities a=0.57, b=0.19, c=0.19, d=0.05)
+Graph createRMatGraph(int scale, int edgeFactor, unsigned seed) {
+    if (scale <= 0 || scale > 30) {
+        throw invalid_argument("R-MAT scale must be between 1 and 30");
+    }
+    
+    int numVertices = 1 << scale;
+    long long numEdges = static_cast<long long>(edgeFactor) * numVertices;
+    
+    Graph graph;
+    graph.addVertices(numVertices);
+    
+    const double a = 0.57, b = 0.19, c = 0.19;
+    mt19937 rng(seed);
+    uniform_real_distribution<double> unit(0.0, 1.0);
+    uniform_real_distribution<double> weight(1.0, 100.0);
+    
+    for (long long e = 0; e < numEdges; e++) {
+        int from = 0;
+        int to = 0;
+        for (int bit = scale - 1; bit >= 0; bit--) {
+            double p = unit(rng);
+            if (p < a) {
+                // top-left quadrant
+            } else if (p < a + b) {
+                to |= 1 << bit;
+            } else if (p < a + b + c) {
+                from |= 1 << bit;
+            } else {
+                from |= 1 << bit;
+                to |= 1 << bit;
+            }
+        }
+        if (from != to) {
+            graph.addEdge(from, to, weight(rng));
+        }
+    }
+    
+    return graph;
+}
+
+// Load a DIMACS shortest-path file (.gr): "p sp <n> <m>" header followed by
+// "a <from> <to> <weight>" arcs with 1-based vertex ids
+Graph loadDimacsGraph(const string& filename) {
+    ifstream in(filename);
+    if (!in) {
+        throw runtime_error("Cannot open DIMACS file '" + filename + "'");
+    }
+    
+    Graph graph;
+    bool haveHeader = false;
+    int numVertices = 0;
+    string line;
+    long long lineNumber = 0;
+    
+    while (getline(in, line)) {
+        lineNumber++;
+        if (line.empty() || line[0] == 'c') {
+            continue;
+        }
+        
+        if (line[0] == 'p') {
+            istringstream header(line);
+            string p, format;
+            long long numArcs;
+            if (!(header >> p >> format >> numVertices >> numArcs) || format != "sp" || numVertices < 0) {
+                throw runtime_error("Malformed DIMACS header on line " + to_string(lineNumber));
+            }
+            graph.addVertices(numVertices);
+            haveHeader = true;
+        } else if (line[0] == 'a') {
+            if (!haveHeader) {
+                throw runtime_error("DIMACS arc before problem line on line " + to_string(lineNumber));
+            }
+            char* cursor = &line[1];
+            char* end;
+            long from = strtol(cursor, &end, 10);
+            if (end == cursor) throw runtime_error("Malformed DIMACS arc on line " + to_string(lineNumber));
+            cursor = end;
+            long to = strtol(cursor, &end, 10);
+            if (end == cursor) throw runtime_error("Malformed DIMACS arc on line " + to_string(lineNumber));
+            cursor = end;
+            double weight = strtod(cursor, &end);
+            if (end == cursor) throw runtime_error("Malformed DIMACS arc on line " + to_string(lineNumber));
+            
+            if (from < 1 || from > numVertices || to < 1 || to > numVertices) {
+                throw runtime_error("DIMACS arc vertex out of range on line " + to_string(lineNumber));
             }
+            if (!(weight >= 0)) {
+                throw runtime_error("Negative DIMACS arc weight on line " + to_string(lineNumber));
+            }
+            graph.addArc(from - 1, to - 1, weight);
         }
+    }
+    
+    if (!haveHeader) {
+        throw runtime_error("DIMACS file '" + filename + "' has no problem line");
+    }
+    
+    return graph;
+}
+
+// Time random queries in every search mode and report queries/s,
+// settled vertices per query and memory
+void runBenchmark(const Graph& graph, const string& label, int numQueries, unsigned seed) {
+    int numVertices = graph.getNumVertices();
+    if (numVertices == 0 || numQueries <= 0) {
+        cout << label << ": nothing to benchmark" << endl;
+        return;
+    }
+    
+    mt19937 rng(seed);
+    uniform_int_distribution<int> pick(0, numVertices - 1);
+    vector<pair<int, int>> queries(numQueries);
+    for (auto& query : queries) {
+        query = {pick(rng), pick(rng)};
+    }
+    
+    DijkstraAlgorithm dijkstra(&graph);
+    
+    cout << "\n" << string(78, '=') << endl;
+    cout << label << ": " << numVertices << " vertices, " << graph.getNumArcs() 
+         << " arcs, graph memory " << fixed << setprecision(1) 
+         << graph.getMemoryUsage() / (1024.0 * 1024.0) << " MiB" << endl;
+    cout << string(78, '-') << endl;
+    cout << left << setw(22) << "Mode" << right << setw(14) << "Queries/s" 
+         << setw(16) << "Settled/query" << setw(14) << "Avg ms" 
+         << setw(12) << "Peak MiB" << endl;
+    
+    const char* modes[] = {"point-to-point", "one-to-all"};
+    for (int mode = 0; mode < 2; mode++) {
+        long long settled = 0;
+        size_t peakMemory = 0;
         
-        return distances;
+        auto startTime = chrono::steady_clock::now();
+        for (const auto& query : queries) {
+            if (mode == 0) {
+                dijkstra.findShortestDistance(query.first, query.second);
+            } else {
+                dijkstra.findShortestDistances(query.first);
+            }
+            settled += dijkstra.getLastSettledCount();
+            peakMemory = max(peakMemory, dijkstra.getLastWorkingMemory());
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+        
+        cout << left << setw(22) << modes[mode] << right 
+             << setw(14) << setprecision(1) << numQueries / seconds
+             << setw(16) << setprecision(0) << static_cast<double>(settled) / numQueries
+             << setw(14) << setprecision(3) << 1000.0 * seconds / numQueries
+             << setw(12) << setprecision(2) 
+             << (graph.getMemoryUsage() + peakMemory) / (1024.0 * 1024.0) << endl;
     }
-};
+    cout << string(78, '=') << endl;
+}
+
+// Benchmark every generator (and an optional DIMACS file) at a realistic size
+void runBenchmarkSuite(const string& dimacsFile, int numQueries) {
+    runBenchmark(createGridGraph(512, 512, 1), "Grid 512x512", numQueries, 42);
+    runBenchmark(createRandomGeometricGraph(200000, 8.0, 2), "Random geometric n=200000", numQueries, 42);
+    runBenchmark(createRMatGraph(17, 8, 3), "R-MAT scale=17", numQueries, 42);
+    if (!dimacsFile.empty()) {
+        runBenchmark(loadDimacsGraph(dimacsFile), "DIMACS " + dimacsFile, numQueries, 42);
+    }
+}
  
 Graph createSampleGraph() {
     Graph graph;
@@ -275,32 +629,94 @@ Graph createUserGraph() {
     
     return graph;
 }
+
+Graph createSyntheticGraph() {
+    int type;
+    cout << "\nChoose generator:" << endl;
+    cout << "1. Road-like grid" << endl;
+    cout << "2. Random geometric" << endl;
+    cout << "3. R-MAT power-law" << endl;
+    cout << "Enter your choice (1-3): ";
+    cin >> type;
+    
+    if (type == 2) {
+        int numVertices;
+        double averageDegree;
+        cout << "Enter number of vertices and average degree: ";
+        cin >> numVertices >> averageDegree;
+        return createRandomGeometricGraph(numVertices, averageDegree, 1);
+    }
+    if (type == 3) {
+        int scale, edgeFactor;
+        cout << "Enter scale (log2 of vertices) and edge factor: ";
+        cin >> scale >> edgeFactor;
+        return createRMatGraph(scale, edgeFactor, 1);
+    }
+    
+    int gridRows, gridCols;
+    cout << "Enter grid rows and columns: ";
+    cin >> gridRows >> gridCols;
+    return createGridGraph(gridRows, gridCols, 1);
+}
  
-int main() {
+int main(int argc, char* argv[]) {
     cout << "Dijkstra's Algorithm Implementation" << endl;
     cout << "===================================" << endl;
     
+    // Non-interactive benchmark: dijkstra --bench [file.gr]
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        try {
+            runBenchmarkSuite(argc > 2 ? argv[2] : "", 20);
+        } catch (const exception& e) {
+            cout << "Error: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+    
     Graph graph;
     int choice;
     
     cout << "\nChoose graph input method:" << endl;
     cout << "1. Use sample graph" << endl;
     cout << "2. Create custom graph" << endl;
-    cout << "Enter your choice (1 or 2): ";
+    cout << "3. Generate synthetic graph" << endl;
+    cout << "4. Load DIMACS graph file" << endl;
+    cout << "Enter your choice (1-4): ";
     cin >> choice;
     
-    if (choice == 1) {
-        graph = createSampleGraph();
-        cout << "\nSample graph created successfully!" << endl;
-    } else if (choice == 2) {
-        graph = createUserGraph();
-        cout << "\nCustom graph created successfully!" << endl;
-    } else {
-        cout << "Invalid choice. Using sample graph." << endl;
+    try {
+        if (choice == 1) {
+            graph = createSampleGraph();
+            cout << "\nSample graph created successfully!" << endl;
+        } else if (choice == 2) {
+            graph = createUserGraph();
+            cout << "\nCustom graph created successfully!" << endl;
+        } else if (choice == 3) {
+            graph = createSyntheticGraph();
+            cout << "\nSynthetic graph created successfully!" << endl;
+        } else if (choice == 4) {
+            string filename;
+            cout << "Enter DIMACS file name: ";
+            cin >> filename;
+            graph = loadDimacsGraph(filename);
+            cout << "\nDIMACS graph loaded successfully!" << endl;
+        } else {
+            cout << "Invalid choice. Using sample graph." << endl;
+            graph = createSampleGraph();
+        }
+    } catch (const exception& e) {
+        cout << "Error: " << e.what() << ". Using sample graph." << endl;
         graph = createSampleGraph();
     }
     
-    graph.displayGraph();
+    // Only print small graphs in full
+    if (graph.getNumVertices() <= 50) {
+        graph.displayGraph();
+    } else {
+        cout << "Graph has " << graph.getNumVertices() << " vertices and " 
+             << graph.getNumArcs() << " arcs" << endl;
+    }
     
     DijkstraAlgorithm dijkstra(&graph);
     
@@ -311,8 +727,9 @@ int main() {
         cout << "1. Find shortest path between two vertices" << endl;
         cout << "2. Find shortest distances from a vertex to all others" << endl;
         cout << "3. Display graph" << endl;
-        cout << "4. Exit" << endl;
-        cout << "Enter your choice (1-4): ";
+        cout << "4. Run benchmark on this graph" << endl;
+        cout << "5. Exit" << endl;
+        cout << "Enter your choice (1-5): ";
         
         cin >> choice;
         
@@ -362,7 +779,15 @@ int main() {
                 graph.displayGraph();
                 break;
                 
-            case 4:
+            case 4: {
+                int numQueries;
+                cout << "\nEnter number of random queries: ";
+                cin >> numQueries;
+                runBenchmark(graph, "Current graph", numQueries, 42);
+                break;
+            }
+                
+            case 5:
                 cout << "\nThank you for using Dijkstra's Algorithm!" << endl;
                 return 0;
                 
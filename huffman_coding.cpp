@@ -2,140 +2,752 @@
 #include <queue>
 #include <vector>
 #include <string>
+#include <array>
 #include <map>
+#include <cstring>
+#include <cstdio>
 #include <algorithm>
 #include <iomanip>
+#include <stdexcept>
+#include <cstdint>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <cstdlib>
 
 using namespace std;
 
-// Huffman Tree Node class
-class HuffmanNode {
-public:
+// Huffman Tree Node, stored in a flat array: children are indices into the
+// array (-1 for none), so a tree over n symbols is 2n - 1 contiguous nodes
+struct HuffmanNode {
     char data;                    // Character (only for leaf nodes)
-    int frequency;               // Frequency of the character
-    HuffmanNode* left;           // Left child
-    HuffmanNode* right;          // Right child
-    bool isLeaf;                 // True if this is a leaf node
+    int frequency;                // Frequency of the character
+    int left;                     // Index of left child, -1 for leaves
+    int right;                    // Index of right child, -1 for leaves
+    
+    bool isLeaf() const { return left < 0; }
+};
 
-    // Constructor for leaf nodes
-    HuffmanNode(char ch, int freq) : data(ch), frequency(freq), left(nullptr), right(nullptr), isLeaf(true) {}
+// Comparator for priority queue of node indices (min-heap based on frequency)
+struct CompareNodes {
+    const vector<HuffmanNode>* nodes;
+    
+    bool operator()(int a, int b) const {
+        return (*nodes)[a].frequency > (*nodes)[b].frequency; // Min-heap: smaller frequency has higher priority
+    }
+};
+
+// Huffman code lengths computed in place (Moffat and Katajainen, "In-place
+// calculation of minimum-redundancy codes"): on entry a[0, n) holds frequencies
+// in non-decreasing order, on exit a[i] is the code length of symbol i. Three
+// linear passes reuse the array for parent pointers, then internal node depths,
+// then leaf depths, so no tree is built. A single symbol gets length 0.
+template <typename Count>
+void moffatKatajainenInPlace(Count* a, int n) {
+    if (n == 0) return;
+    if (n == 1) {
+        a[0] = 0;
+        return;
+    }
     
-    // Constructor for internal nodes
-    HuffmanNode(int freq, HuffmanNode* l, HuffmanNode* r) : data('\0'), frequency(freq), left(l), right(r), isLeaf(false) {}
+    // Pass 1, left to right: a[next] becomes the weight of internal node next,
+    // and each consumed internal node's slot becomes its parent's index
+    a[0] += a[1];
+    int root = 0, leaf = 2;
+    for (int next = 1; next < n - 1; next++) {
+        if (leaf >= n || a[root] < a[leaf]) {
+            a[next] = a[root];
+            a[root++] = next;
+        } else {
+            a[next] = a[leaf++];
+        }
+        
+        if (leaf >= n || (root < next && a[root] < a[leaf])) {
+            a[next] += a[root];
+            a[root++] = next;
+        } else {
+            a[next] += a[leaf++];
+        }
+    }
     
-    // Destructor to clean up memory
-    ~HuffmanNode() {
-        delete left;
-        delete right;
+    // Pass 2, right to left: parent indices become internal node depths
+    a[n - 2] = 0;
+    for (int next = n - 3; next >= 0; next--) {
+        a[next] = a[a[next]] + 1;
     }
+    
+    // Pass 3, right to left: count internal nodes per depth and assign the
+    // remaining slots at each depth to leaves
+    int available = 1, used = 0, depth = 0;
+    root = n - 2;
+    int next = n - 1;
+    while (available > 0) {
+        while (root >= 0 && (int)a[root] == depth) {
+            used++;
+            root--;
+        }
+        while (available > used) {
+            a[next--] = depth;
+            available--;
+        }
+        available = 2 * used;
+        depth++;
+        used = 0;
+    }
+}
+
+// Huffman code lengths for an alphabet of any size (e.g. 2^16 LZ77 tokens).
+// Symbols with frequency 0 get length 0 (no code). The used symbols are sorted by
+// frequency with an LSD radix sort on 8-bit digits, stopping above the largest
+// frequency and skipping the scatter for any digit all symbols share (e.g. a
+// middle digit that is zero everywhere); moffatKatajainenInPlace then computes
+// the lengths.
+inline vector<int> huffmanCodeLengths(const vector<uint64_t>& frequencies) {
+    vector<uint32_t> order, buffer;
+    uint64_t maxFrequency = 0;
+    for (size_t i = 0; i < frequencies.size(); i++) {
+        if (frequencies[i] > 0) {
+            order.push_back((uint32_t)i);
+            maxFrequency = max(maxFrequency, frequencies[i]);
+        }
+    }
+    
+    buffer.resize(order.size());
+    for (int shift = 0; shift < 64 && (maxFrequency >> shift) > 0; shift += 8) {
+        size_t counts[257] = {};
+        for (uint32_t symbol : order) {
+            counts[((frequencies[symbol] >> shift) & 0xFF) + 1]++;
+        }
+        if (*max_element(counts + 1, counts + 257) == order.size()) {
+            continue;
+        }
+        for (int d = 0; d < 256; d++) {
+            counts[d + 1] += counts[d];
+        }
+        for (uint32_t symbol : order) {
+            buffer[counts[(frequencies[symbol] >> shift) & 0xFF]++] = symbol;
+        }
+        order.swap(buffer);
+    }
+    
+    vector<uint64_t> work(order.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        work[i] = frequencies[order[i]];
+    }
+    moffatKatajainenInPlace(work.data(), (int)work.size());
+    
+    vector<int> lengths(frequencies.size(), 0);
+    for (size_t i = 0; i < order.size(); i++) {
+        lengths[order[i]] = (int)work[i];
+    }
+    return lengths;
+}
+
+// Optimal code lengths of at most maxLength bits (package-merge, Larmore and
+// Hirschberg). Symbols with frequency 0 get length 0. When the unrestricted
+// Huffman code already fits it is returned as is; otherwise, with the n used
+// symbols sorted by frequency, level maxLength lists the leaves and each level
+// above merges the leaves with the pairwise packages of the level below. The
+// cheapest 2n - 2 items of the top level fix the lengths: every leaf taken at a
+// level adds one bit to that symbol. Only a leaf/package flag per item is kept,
+// so time and memory are O(n * maxLength).
+inline vector<int> lengthLimitedCodeLengths(const vector<uint64_t>& frequencies, int maxLength) {
+    vector<int> lengths = huffmanCodeLengths(frequencies);
+    if (lengths.empty() || *max_element(lengths.begin(), lengths.end()) <= maxLength) {
+        return lengths;
+    }
+    
+    vector<uint32_t> symbols;
+    for (size_t i = 0; i < frequencies.size(); i++) {
+        if (frequencies[i] > 0) symbols.push_back((uint32_t)i);
+    }
+    int n = (int)symbols.size();
+    if (maxLength < 1 || maxLength >= 64 || ((uint64_t)1 << maxLength) < (uint64_t)n) {
+        throw invalid_argument("Maximum code length too small for the alphabet");
+    }
+    stable_sort(symbols.begin(), symbols.end(), [&](uint32_t a, uint32_t b) {
+        return frequencies[a] < frequencies[b];
+    });
+    
+    // isPackage[level][k]: whether item k of that level's sorted list is a package
+    // (level 0 is the top, maxLength - 1 the leaves-only bottom level)
+    vector<vector<char>> isPackage(maxLength);
+    vector<uint64_t> weights, merged;
+    for (uint32_t symbol : symbols) weights.push_back(frequencies[symbol]);
+    isPackage[maxLength - 1].assign(n, 0);
+    for (int level = maxLength - 2; level >= 0; level--) {
+        merged.clear();
+        vector<char>& flags = isPackage[level];
+        size_t packages = weights.size() / 2;
+        int leaf = 0;
+        size_t package = 0;
+        while (leaf < n || package < packages) {
+            uint64_t packageWeight = package < packages ? weights[2 * package] + weights[2 * package + 1] : 0;
+            if (package >= packages || (leaf < n && frequencies[symbols[leaf]] <= packageWeight)) {
+                merged.push_back(frequencies[symbols[leaf++]]);
+                flags.push_back(0);
+            } else {
+                merged.push_back(packageWeight);
+                flags.push_back(1);
+                package++;
+            }
+        }
+        weights.swap(merged);
+    }
+    
+    // Walk down from the 2n - 2 cheapest top-level items: the leaves taken at a
+    // level are always the cheapest symbols, and p packages taken expand into
+    // the 2p cheapest items of the level below
+    vector<int> sortedLengths(n, 0);
+    size_t take = 2 * (size_t)n - 2;
+    for (int level = 0; level < maxLength && take > 0; level++) {
+        size_t leaves = 0;
+        for (size_t k = 0; k < take; k++) {
+            leaves += isPackage[level][k] == 0;
+        }
+        for (size_t k = 0; k < leaves; k++) {
+            sortedLengths[k]++;
+        }
+        take = 2 * (take - leaves);
+    }
+    
+    fill(lengths.begin(), lengths.end(), 0);
+    for (int i = 0; i < n; i++) {
+        lengths[symbols[i]] = sortedLengths[i];
+    }
+    return lengths;
+}
+
+// One canonical codeword: the low `length` bits of `bits`, sent MSB-first
+struct HuffmanCode {
+    uint64_t bits;
+    int length;                   // 0 for symbols without a code
 };
 
-// Comparator for priority queue (min-heap based on frequency)
-struct CompareNodes {
-    bool operator()(HuffmanNode* a, HuffmanNode* b) {
-        return a->frequency > b->frequency; // Min-heap: smaller frequency has higher priority
+// Canonical code assignment: shorter codes come first and codes of equal length
+// are consecutive integers in symbol order, so the lengths alone define the code
+inline array<HuffmanCode, 256> canonicalCodes(const array<int, 256>& lengths) {
+    const int MAX_LENGTH = 64;
+    vector<uint64_t> lengthCount(MAX_LENGTH + 1, 0), nextCode(MAX_LENGTH + 1, 0);
+    for (int symbol = 0; symbol < 256; symbol++) {
+        if (lengths[symbol] < 0 || lengths[symbol] > MAX_LENGTH) {
+            throw runtime_error("Huffman code length must be between 0 and 64 bits");
+        }
+        lengthCount[lengths[symbol]]++;
+    }
+    lengthCount[0] = 0;
+    
+    uint64_t code = 0;
+    for (int length = 1; length <= MAX_LENGTH; length++) {
+        code = (code + lengthCount[length - 1]) << 1;
+        nextCode[length] = code;
+    }
+    
+    array<HuffmanCode, 256> codes;
+    for (int symbol = 0; symbol < 256; symbol++) {
+        int length = lengths[symbol];
+        codes[symbol] = {length > 0 ? nextCode[length]++ : 0, length};
+    }
+    return codes;
+}
+
+// Bit-level output that packs codes MSB-first into a 64-bit accumulator and
+// stores whole words (big-endian) at a time, so the per-code cost is a shift and
+// an OR; the caller sizes the output for the worst case up front
+class BitWriter {
+private:
+    uint8_t* out;                 // Next byte to write
+    uint8_t* start;
+    uint64_t buffer;              // Pending bits, left-aligned
+    int count;                    // Number of pending bits (0-63)
+    
+    void storeWord(uint64_t word) {
+        word = __builtin_bswap64(word);
+        memcpy(out, &word, 8);
+        out += 8;
+    }
+
+public:
+    explicit BitWriter(uint8_t* output) : out(output), start(output), buffer(0), count(0) {}
+    
+    // Append the low length bits of bits (1 <= length <= 64, higher bits zero)
+    void write(uint64_t bits, int length) {
+        if (count + length < 64) {
+            buffer |= bits << (64 - count - length);
+            count += length;
+            return;
+        }
+        int spill = count + length - 64;
+        storeWord(buffer | (bits >> spill));
+        buffer = spill > 0 ? bits << (64 - spill) : 0;
+        count = spill;
+    }
+    
+    // Flush the pending bits (zero-padded to a byte) and return the total bit count
+    uint64_t finish() {
+        uint64_t totalBits = (uint64_t)(out - start) * 8 + count;
+        for (int shift = 56; count > 0; shift -= 8, count -= 8) {
+            *out++ = (uint8_t)(buffer >> shift);
+        }
+        buffer = 0;
+        count = 0;
+        return totalBits;
     }
 };
 
-class HuffmanCoding {
+// Table-driven decoder for a canonical code over byte values, reading MSB-first
+// streams written by BitWriter.
+//
+// The next 12 bits of a 64-bit window index a 4096-entry primary table (16 KB,
+// L1-resident). An entry holds one to three complete symbols whose codes fit
+// in those 12 bits together with their total length, so short codes decode
+// several bytes per lookup with no per-bit branches. Codes of 13-24 bits go
+// through a secondary table per 12-bit prefix; longer codes and bit patterns
+// that are not codes take a bit-by-bit canonical slow path.
+class HuffmanDecoder {
 private:
-    HuffmanNode* root;
-    map<char, string> huffmanCodes;
+    static constexpr int PRIMARY_BITS = 12;
+    static constexpr int MAX_SECONDARY_BITS = 12;
+    
+    // Entry layout: bits consumed in 31..28, symbol count in 27..26, slow-path
+    // flag in 25, payload in 23..0. With 1-3 symbols the payload holds them in
+    // bits 7..0, 15..8 and 23..16; with 0 symbols it is the offset of a secondary
+    // table indexed by (bits) further bits, unless the slow-path flag is set.
+    static constexpr uint32_t SLOW_PATH = 1u << 25;
+    
+    vector<uint32_t> primary;
+    vector<uint32_t> secondary;
+    
+    // Canonical decoding data for the slow path
+    array<uint64_t, 65> firstCode{};   // First codeword of each length
+    array<int, 65> lengthCount{};      // Number of codes of each length
+    array<int, 65> firstIndex{};       // Index of that first code in sortedSymbols
+    vector<uint8_t> sortedSymbols;     // Symbols ordered by (length, symbol)
+    int maxLength = 0;
+    
+    static uint64_t loadBigEndian(const uint8_t* p) {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        return __builtin_bswap64(word);
+    }
     
-    // Helper function to generate Huffman codes using preorder traversal
-    void generateCodes(HuffmanNode* node, string code) {
-        if (node == nullptr) return;
+    static uint32_t makeEntry(int bits, int count, uint32_t payload) {
+        return ((uint32_t)bits << 28) | ((uint32_t)count << 26) | payload;
+    }
+    
+    static int entryBits(uint32_t entry) { return entry >> 28; }
+    static int entryCount(uint32_t entry) { return (entry >> 26) & 3; }
+    
+    // Decode one symbol bit by bit from bit position pos; returns its length
+    int decodeSlow(const uint8_t* in, size_t inBytes, uint64_t pos, uint8_t& symbol) const {
+        uint64_t code = 0;
+        for (int length = 1; length <= maxLength; length++) {
+            uint64_t bit = pos / 8 < inBytes ? (in[pos / 8] >> (7 - pos % 8)) & 1 : 0;
+            code = (code << 1) | bit;
+            pos++;
+            if (lengthCount[length] > 0 && code - firstCode[length] < (uint64_t)lengthCount[length]) {
+                symbol = sortedSymbols[firstIndex[length] + (code - firstCode[length])];
+                return length;
+            }
+        }
+        throw runtime_error("Invalid Huffman code in input");
+    }
+
+public:
+    // Build the tables for the canonical code with the given lengths (0 = unused)
+    explicit HuffmanDecoder(const array<int, 256>& lengths) : primary(1 << PRIMARY_BITS, SLOW_PATH) {
+        array<HuffmanCode, 256> codes = canonicalCodes(lengths);
+        for (const HuffmanCode& code : codes) {
+            if (code.length > 0 && code.length < 64 && (code.bits >> code.length) != 0) {
+                throw runtime_error("Code lengths do not form a prefix code");
+            }
+        }
         
-        // If it's a leaf node, store the code
-        if (node->isLeaf) {
-            huffmanCodes[node->data] = code;
-            return;
+        for (int length = 1; length <= 64; length++) {
+            firstIndex[length] = (int)sortedSymbols.size();
+            for (int symbol = 0; symbol < 256; symbol++) {
+                if (codes[symbol].length == length) {
+                    if (lengthCount[length]++ == 0) firstCode[length] = codes[symbol].bits;
+                    sortedSymbols.push_back((uint8_t)symbol);
+                    maxLength = length;
+                }
+            }
         }
         
-        // Recursively traverse left (add '0') and right (add '1')
-        generateCodes(node->left, code + "0");
-        generateCodes(node->right, code + "1");
+        // Short codes fill every primary slot that starts with them
+        for (int symbol = 0; symbol < 256; symbol++) {
+            int length = codes[symbol].length;
+            if (length > 0 && length <= PRIMARY_BITS) {
+                uint32_t first = (uint32_t)codes[symbol].bits << (PRIMARY_BITS - length);
+                fill(primary.begin() + first, primary.begin() + first + (1u << (PRIMARY_BITS - length)),
+                     makeEntry(length, 1, symbol));
+            }
+        }
+        
+        // Long codes go to one secondary table per 12-bit prefix, sized for the
+        // longest code under that prefix; prefixes with codes beyond 24 bits keep
+        // the slow path
+        vector<int> prefixMax(1 << PRIMARY_BITS, 0);
+        for (int symbol = 0; symbol < 256; symbol++) {
+            int length = codes[symbol].length;
+            if (length > PRIMARY_BITS) {
+                uint64_t prefix = codes[symbol].bits >> (length - PRIMARY_BITS);
+                prefixMax[prefix] = max(prefixMax[prefix], length);
+            }
+        }
+        for (int prefix = 0; prefix < (1 << PRIMARY_BITS); prefix++) {
+            int subBits = prefixMax[prefix] - PRIMARY_BITS;
+            if (subBits > 0 && subBits <= MAX_SECONDARY_BITS) {
+                primary[prefix] = makeEntry(subBits, 0, (uint32_t)secondary.size());
+                secondary.resize(secondary.size() + ((size_t)1 << subBits), SLOW_PATH);
+            }
+        }
+        for (int symbol = 0; symbol < 256; symbol++) {
+            int length = codes[symbol].length;
+            if (length <= PRIMARY_BITS) continue;
+            uint32_t entry = primary[codes[symbol].bits >> (length - PRIMARY_BITS)];
+            if (entry & SLOW_PATH) continue;
+            
+            int subBits = entryBits(entry);
+            int extra = length - PRIMARY_BITS;
+            uint64_t low = codes[symbol].bits & ((1ull << extra) - 1);
+            size_t first = (entry & 0xFFFFFF) + (low << (subBits - extra));
+            fill(secondary.begin() + first, secondary.begin() + first + ((size_t)1 << (subBits - extra)),
+                 makeEntry(extra, 1, symbol));
+        }
+        
+        // Append the codes that follow a short code while the rest of the 12-bit
+        // window still determines them completely
+        vector<uint32_t> single = primary;
+        for (uint32_t index = 0; index < single.size(); index++) {
+            uint32_t entry = single[index];
+            if (entryCount(entry) != 1) continue;
+            
+            int bits = entryBits(entry);
+            uint32_t payload = entry & 0xFF;
+            int count = 1;
+            while (count < 3) {
+                uint32_t next = single[(index << bits) & ((1u << PRIMARY_BITS) - 1)];
+                if (entryCount(next) != 1 || bits + entryBits(next) > PRIMARY_BITS) break;
+                payload |= (next & 0xFF) << (8 * count);
+                bits += entryBits(next);
+                count++;
+            }
+            primary[index] = makeEntry(bits, count, payload);
+        }
     }
     
-    // Helper function for preorder traversal to print codes in the required order
-    void preorderTraversal(HuffmanNode* node, vector<string>& codes, string currentCode = "") {
-        if (node == nullptr) return;
+    // Decode n bytes from in (inBytes bytes) into out and return the number of
+    // bits consumed; throws on invalid or truncated input
+    uint64_t decode(const uint8_t* in, size_t inBytes, uint8_t* out, size_t n) const {
+        uint64_t pos = 0;
+        size_t produced = 0;
         
-        // If it's a leaf node, add its code to the result
-        if (node->isLeaf) {
-            codes.push_back(currentCode);
-            return;
+        // Fast loop while 8 bytes can be loaded at pos. The window is consumed by
+        // shifting and reloaded only when fewer than 24 bits (the longest table
+        // code) remain, so the refill stays off the decode dependency chain.
+        // Every step stores three bytes, so the loop stops two short of n.
+        const int MIN_WINDOW_BITS = PRIMARY_BITS + MAX_SECONDARY_BITS;
+        uint64_t window = 0;
+        int available = 0;
+        while (produced + 3 <= n) {
+            if (available < MIN_WINDOW_BITS) {
+                if ((pos >> 3) + 8 > inBytes) break;
+                window = loadBigEndian(in + (pos >> 3)) << (pos & 7);
+                available = 64 - (int)(pos & 7);
+            }
+            
+            uint32_t entry = primary[window >> (64 - PRIMARY_BITS)];
+            int bits = entryBits(entry);
+            if (entryCount(entry) > 0) {
+                out[produced] = (uint8_t)entry;
+                out[produced + 1] = (uint8_t)(entry >> 8);
+                out[produced + 2] = (uint8_t)(entry >> 16);
+                produced += entryCount(entry);
+            } else if (!(entry & SLOW_PATH) &&
+                       entryCount(entry = secondary[(entry & 0xFFFFFF) + 
+                                                    ((window << PRIMARY_BITS) >> (64 - bits))]) == 1) {
+                out[produced++] = (uint8_t)entry;
+                bits = PRIMARY_BITS + entryBits(entry);
+            } else {
+                pos += decodeSlow(in, inBytes, pos, out[produced++]);
+                available = 0;
+                continue;
+            }
+            pos += bits;
+            window <<= bits;
+            available -= bits;
         }
         
-        // Visit left subtree first (add '0'), then right subtree (add '1')
-        preorderTraversal(node->left, codes, currentCode + "0");
-        preorderTraversal(node->right, codes, currentCode + "1");
+        // Tail: the last few symbols, bit by bit
+        while (produced < n) {
+            pos += decodeSlow(in, inBytes, pos, out[produced++]);
+            if (pos > (uint64_t)inBytes * 8) {
+                throw runtime_error("Truncated Huffman stream");
+            }
+        }
+        return pos;
     }
+};
 
-public:
-    HuffmanCoding() : root(nullptr) {}
+class HuffmanCoding {
+private:
+    vector<HuffmanNode> nodes;          // Leaves first, then internal nodes in merge order
+    int root;                           // Index of the root, -1 for an empty tree
+    array<HuffmanCode, 256> canonical;  // Canonical code of each byte value
+    int maxCodeLength;                  // Longest code allowed, 0 for no limit
     
-    ~HuffmanCoding() {
-        delete root;
+    // Code length of every leaf from its depth in the tree, then canonical
+    // codewords from the lengths; an explicit stack keeps deep (skewed) trees
+    // off the call stack. Past maxCodeLength the lengths come from package-merge
+    // over the leaf frequencies instead, so the codes no longer follow the tree.
+    void generateCodes() {
+        array<int, 256> lengths{};
+        vector<pair<int, int>> stack;  // (node, depth)
+        if (root >= 0) stack.push_back({root, 0});
+        
+        while (!stack.empty()) {
+            auto [node, depth] = stack.back();
+            stack.pop_back();
+            
+            // A lone leaf still needs one bit to be encodable
+            if (nodes[node].isLeaf()) {
+                lengths[(unsigned char)nodes[node].data] = max(depth, 1);
+                continue;
+            }
+            
+            stack.push_back({nodes[node].right, depth + 1});
+            stack.push_back({nodes[node].left, depth + 1});
+        }
+        
+        if (maxCodeLength > 0 && *max_element(lengths.begin(), lengths.end()) > maxCodeLength) {
+            vector<uint64_t> frequencies(256, 0);
+            for (const HuffmanNode& node : nodes) {
+                if (node.isLeaf()) frequencies[(unsigned char)node.data] += max(node.frequency, 1);
+            }
+            vector<int> limited = lengthLimitedCodeLengths(frequencies, maxCodeLength);
+            copy(limited.begin(), limited.end(), lengths.begin());
+        }
+        canonical = canonicalCodes(lengths);
     }
     
-    // Build Huffman tree from characters and their frequencies
-    void buildTree(const string& characters, const vector<int>& frequencies) {
-        // Create a min-heap priority queue
-        priority_queue<HuffmanNode*, vector<HuffmanNode*>, CompareNodes> minHeap;
+    // Helper function for preorder traversal to print codes in the required order:
+    // the tree-path code of every leaf (left adds '0', right adds '1'). These
+    // are the codes of the tree itself; encode() uses the canonical ones.
+    void preorderTraversal(vector<string>& codes) const {
+        struct Frame {
+            int node;
+            int depth;
+            uint64_t path;                // Low depth bits, root edge first
+        };
+        vector<Frame> stack;
+        if (root >= 0) stack.push_back({root, 0, 0});
         
-        // Create leaf nodes for each character and add to min-heap
-        for (size_t i = 0; i < characters.length(); i++) {
-            HuffmanNode* node = new HuffmanNode(characters[i], frequencies[i]);
-            minHeap.push(node);
+        while (!stack.empty()) {
+            Frame frame = stack.back();
+            stack.pop_back();
+            
+            // If it's a leaf node, add its code to the result
+            if (nodes[frame.node].isLeaf()) {
+                codes.push_back(codeText(frame.path, frame.depth));
+                continue;
+            }
+            if (frame.depth == 64) {
+                throw runtime_error("Huffman tree path longer than 64 bits");
+            }
+            
+            // Visit left subtree first (add '0'), then right subtree (add '1')
+            stack.push_back({nodes[frame.node].right, frame.depth + 1, (frame.path << 1) | 1});
+            stack.push_back({nodes[frame.node].left, frame.depth + 1, frame.path << 1});
+        }
+    }
+    
+    // The low length bits of bits as '0'/'1' text, most significant first
+    static string codeText(uint64_t bits, int length) {
+        string text(length, '0');
+        for (int i = 0; i < length; i++) {
+            if ((bits >> (length - 1 - i)) & 1) text[i] = '1';
+        }
+        return text;
+    }
+    
+    // O(n log n) construction from the leaves in nodes: repeatedly merge the two
+    // nodes with smallest frequencies taken from a min-heap
+    void buildTreeWithHeap() {
+        vector<int> heapStorage;
+        heapStorage.reserve(nodes.size());
+        priority_queue<int, vector<int>, CompareNodes> minHeap(CompareNodes{&nodes}, std::move(heapStorage));
+        for (size_t i = 0; i < nodes.size(); i++) {
+            minHeap.push((int)i);
         }
         
         // Build the tree by repeatedly combining the two nodes with smallest frequencies
         while (minHeap.size() > 1) {
             // Extract the two nodes with minimum frequency
-            HuffmanNode* left = minHeap.top();
+            int left = minHeap.top();
             minHeap.pop();
             
-            HuffmanNode* right = minHeap.top();
+            int right = minHeap.top();
             minHeap.pop();
             
             // Create a new internal node with frequency equal to sum of the two nodes
-            HuffmanNode* merged = new HuffmanNode(left->frequency + right->frequency, left, right);
+            nodes.push_back({'\0', nodes[left].frequency + nodes[right].frequency, left, right});
             
             // Add the merged node back to the min-heap
-            minHeap.push(merged);
+            minHeap.push((int)nodes.size() - 1);
         }
         
         // The remaining node is the root of the Huffman tree
-        root = minHeap.top();
+        if (!minHeap.empty()) {
+            root = minHeap.top();
+        }
+    }
+    
+    // O(n) two-queue construction when the leaves are sorted by frequency: merged
+    // nodes are created in non-decreasing frequency order, so the leaves and the
+    // internal nodes (appended after them) are two sorted queues and the smallest
+    // node is always at the front of one of them
+    void buildTreeTwoQueue() {
+        int leafCount = (int)nodes.size();
+        int nextLeaf = 0;
+        int nextInternal = leafCount;
+        
+        auto takeSmallest = [&]() {
+            bool leafAvailable = nextLeaf < leafCount;
+            bool internalAvailable = nextInternal < (int)nodes.size();
+            if (leafAvailable && (!internalAvailable ||
+                                  nodes[nextLeaf].frequency <= nodes[nextInternal].frequency)) {
+                return nextLeaf++;
+            }
+            return nextInternal++;
+        };
+        
+        for (int merges = 1; merges < leafCount; merges++) {
+            int left = takeSmallest();
+            int right = takeSmallest();
+            nodes.push_back({'\0', nodes[left].frequency + nodes[right].frequency, left, right});
+        }
+        root = (int)nodes.size() - 1;
+    }
+
+public:
+    HuffmanCoding() : root(-1), canonical{}, maxCodeLength(0) {}
+    
+    // Limit codes to maxLength bits (0 removes the limit); applies to the next
+    // buildTree. A limit of 12 keeps every code inside HuffmanDecoder's primary table.
+    void setMaxCodeLength(int maxLength) {
+        if (maxLength < 0 || maxLength > 64) {
+            throw out_of_range("Maximum code length must be between 0 and 64");
+        }
+        maxCodeLength = maxLength;
+    }
+    
+    // Build Huffman tree from characters and their frequencies; frequencies sorted
+    // in non-decreasing order take the linear two-queue path
+    void buildTree(const string& characters, const vector<int>& frequencies) {
+        if (frequencies.size() != characters.length()) {
+            throw invalid_argument("Each character needs exactly one frequency");
+        }
+        size_t n = characters.length();
+        nodes.clear();
+        nodes.reserve(n > 0 ? 2 * n - 1 : 0);
+        canonical = {};
+        root = -1;
+        
+        // Create leaf nodes for each character
+        for (size_t i = 0; i < n; i++) {
+            nodes.push_back({characters[i], frequencies[i], -1, -1});
+        }
+        
+        if (is_sorted(frequencies.begin(), frequencies.end())) {
+            buildTreeTwoQueue();
+        } else {
+            buildTreeWithHeap();
+        }
         
         // Generate Huffman codes
-        generateCodes(root, "");
+        generateCodes();
     }
     
-    // Get all Huffman codes in preorder traversal order
+    // Get the tree-path codes of all leaves in preorder traversal order
     vector<string> getCodesInPreorder() {
         vector<string> codes;
-        if (root != nullptr) {
-            preorderTraversal(root, codes, "");
-        }
+        preorderTraversal(codes);
         return codes;
     }
     
-    // Get the Huffman code for a specific character
-    string getCode(char ch) {
-        return huffmanCodes[ch];
+    // Get the canonical Huffman code for a specific character as '0'/'1' text
+    string getCode(char ch) const {
+        const HuffmanCode& code = canonical[(unsigned char)ch];
+        return codeText(code.bits, code.length);
+    }
+    
+    // Canonical codes of all 256 byte values (length 0 = not in the alphabet)
+    const array<HuffmanCode, 256>& getCanonicalCodes() const {
+        return canonical;
+    }
+    
+    // Code length of every byte value (0 = not in the alphabet); with canonical
+    // codes this is all a decoder needs
+    array<int, 256> getCodeLengths() const {
+        array<int, 256> lengths;
+        for (int symbol = 0; symbol < 256; symbol++) {
+            lengths[symbol] = canonical[symbol].length;
+        }
+        return lengths;
+    }
+    
+    // Upper bound on the encoded size of n bytes, for sizing encode's output
+    size_t maxEncodedBytes(size_t n) const {
+        int maxLength = 0;
+        for (const HuffmanCode& code : canonical) {
+            maxLength = max(maxLength, code.length);
+        }
+        return (n * maxLength + 7) / 8 + 8;
+    }
+    
+    // Encode n bytes with the canonical codes into out (at least maxEncodedBytes(n)
+    // bytes) and return the number of bits written; every byte must have a code
+    uint64_t encode(const uint8_t* data, size_t n, uint8_t* out) const {
+        BitWriter writer(out);
+        for (size_t i = 0; i < n; i++) {
+            const HuffmanCode& code = canonical[data[i]];
+            if (code.length == 0) {
+                throw invalid_argument("Byte has no Huffman code");
+            }
+            writer.write(code.bits, code.length);
+        }
+        return writer.finish();
+    }
+    
+    // Encode a string with the canonical codes into a byte vector (the last byte
+    // is zero-padded)
+    vector<uint8_t> encode(const string& text) const {
+        vector<uint8_t> out(maxEncodedBytes(text.size()));
+        uint64_t bits = encode((const uint8_t*)text.data(), text.size(), out.data());
+        out.resize((bits + 7) / 8);
+        return out;
     }
     
-    // Print all Huffman codes
+    // Decode n characters from the output of encode(), i.e. canonical codes
+    string decode(const vector<uint8_t>& encoded, size_t n) const {
+        HuffmanDecoder decoder(getCodeLengths());
+        string text(n, '\0');
+        decoder.decode(encoded.data(), encoded.size(), (uint8_t*)text.data(), n);
+        return text;
+    }
+    
+    // Print the canonical code of every symbol (what encode() writes)
     void printAllCodes() {
-        cout << "\nHuffman codes:" << endl;
-        for (auto& pair : huffmanCodes) {
-            cout << "  " << pair.first << " : " << pair.second << endl;
+        cout << "\nCanonical Huffman codes:" << endl;
+        for (int symbol = 0; symbol < 256; symbol++) {
+            if (canonical[symbol].length > 0) {
+                cout << "  " << (char)symbol << " : " << getCode((char)symbol) << endl;
+            }
         }
     }
     
-    // Print codes in preorder traversal format (as required by the assignment)
+    // Print the tree-path codes in preorder traversal format (as required by the assignment)
     void printCodesInPreorder() {
         vector<string> codes = getCodesInPreorder();
         cout << "\nHuffman codes in preorder traversal:" << endl;
@@ -146,23 +758,280 @@ public:
     }
     
     // Display the tree structure (for debugging/visualization)
-    void displayTree(HuffmanNode* node, int indent = 0) {
-        if (node == nullptr) return;
+    void displayTree() const {
+        vector<pair<int, int>> stack;  // (node, indent)
+        if (root >= 0) stack.push_back({root, 0});
         
-        for (int i = 0; i < indent; i++) cout << "  ";
+        while (!stack.empty()) {
+            auto [node, indent] = stack.back();
+            stack.pop_back();
+            
+            for (int i = 0; i < indent; i++) cout << "  ";
+            
+            if (nodes[node].isLeaf()) {
+                cout << "Leaf: '" << nodes[node].data << "' (freq: " << nodes[node].frequency << ")" << endl;
+            } else {
+                cout << "Internal: (freq: " << nodes[node].frequency << ")" << endl;
+                stack.push_back({nodes[node].right, indent + 1});
+                stack.push_back({nodes[node].left, indent + 1});
+            }
+        }
+    }
+    
+    // Index of the root in getNodes(), -1 for an empty tree
+    int getRoot() const { return root; }
+    
+    // The tree as a flat node array
+    const vector<HuffmanNode>& getNodes() const { return nodes; }
+};
+
+// Streaming compression: the input is cut into blocks of BLOCK_SIZE bytes and
+// each block gets its own code, so memory stays fixed whatever the input size.
+//
+// Stream:  "HUF1", then blocks, then a 4-byte zero (end marker).
+// Block:   uint32 raw size (little-endian), uint8 type, then
+//          type 0 (Huffman): 32-byte bitmap of the byte values present, their
+//              code lengths minus one as 5-bit fields (MSB-first, byte-padded),
+//              uint32 payload size, payload;
+//          type 1 (stored): the raw bytes, used when coding would not shrink them.
+const size_t BLOCK_SIZE = 1 << 20;
+const char STREAM_MAGIC[4] = {'H', 'U', 'F', '1'};
+const int DEFAULT_MAX_CODE_LENGTH = 12;
+
+// Totals reported by compressStream / decompressStream
+struct StreamStats {
+    uint64_t bytesIn = 0;
+    uint64_t bytesOut = 0;
+};
+
+inline void putUint32(vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out.push_back((uint8_t)(value >> (8 * i)));
+}
+
+inline uint32_t getUint32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Read exactly n bytes unless the stream ends first; returns the count read
+inline size_t readFully(FILE* in, uint8_t* buffer, size_t n) {
+    size_t total = 0;
+    while (total < n) {
+        size_t got = fread(buffer + total, 1, n - total, in);
+        if (got == 0) break;
+        total += got;
+    }
+    return total;
+}
+
+inline void readExactly(FILE* in, uint8_t* buffer, size_t n) {
+    if (readFully(in, buffer, n) != n) {
+        throw runtime_error("Unexpected end of compressed stream");
+    }
+}
+
+inline void writeExactly(FILE* out, const uint8_t* buffer, size_t n) {
+    if (n > 0 && fwrite(buffer, 1, n, out) != n) {
+        throw runtime_error("Write failed");
+    }
+}
+
+// Compress everything from in to out block by block. Codes are limited to
+// maxCodeLength bits (8-32, the header stores lengths in 5 bits); the default of
+// 12 lets the decoder resolve every symbol with one primary-table lookup.
+inline StreamStats compressStream(FILE* in, FILE* out, int maxCodeLength = DEFAULT_MAX_CODE_LENGTH) {
+    if (maxCodeLength < 8 || maxCodeLength > 32) {
+        throw invalid_argument("Maximum code length must be between 8 and 32");
+    }
+    StreamStats stats;
+    vector<uint8_t> block(BLOCK_SIZE);
+    vector<uint8_t> payload(BLOCK_SIZE * maxCodeLength / 8 + 8);
+    vector<uint8_t> header;
+    writeExactly(out, (const uint8_t*)STREAM_MAGIC, 4);
+    stats.bytesOut += 4;
+    
+    size_t size;
+    while ((size = readFully(in, block.data(), BLOCK_SIZE)) > 0) {
+        stats.bytesIn += size;
+        
+        // Four interleaved histograms avoid store-to-load stalls on repeated bytes
+        vector<uint64_t> counts(256, 0);
+        uint32_t partial[4][256] = {};
+        size_t i = 0;
+        for (; i + 4 <= size; i += 4) {
+            partial[0][block[i]]++;
+            partial[1][block[i + 1]]++;
+            partial[2][block[i + 2]]++;
+            partial[3][block[i + 3]]++;
+        }
+        for (; i < size; i++) partial[0][block[i]]++;
+        for (int symbol = 0; symbol < 256; symbol++) {
+            counts[symbol] = (uint64_t)partial[0][symbol] + partial[1][symbol] + partial[2][symbol] + partial[3][symbol];
+        }
+        
+        vector<int> codeLengths = lengthLimitedCodeLengths(counts, maxCodeLength);
+        array<int, 256> lengths;
+        int used = 0;
+        for (int symbol = 0; symbol < 256; symbol++) {
+            // A block of one repeated byte still needs a 1-bit code
+            lengths[symbol] = counts[symbol] > 0 ? max(codeLengths[symbol], 1) : 0;
+            used += counts[symbol] > 0;
+        }
+        array<HuffmanCode, 256> codes = canonicalCodes(lengths);
+        
+        BitWriter writer(payload.data());
+        for (size_t k = 0; k < size; k++) {
+            writer.write(codes[block[k]].bits, codes[block[k]].length);
+        }
+        size_t payloadBytes = (writer.finish() + 7) / 8;
+        
+        header.clear();
+        putUint32(header, (uint32_t)size);
+        size_t huffmanBytes = 32 + (used * 5 + 7) / 8 + 4 + payloadBytes;
+        if (huffmanBytes >= size) {
+            header.push_back(1);
+            writeExactly(out, header.data(), header.size());
+            writeExactly(out, block.data(), size);
+            stats.bytesOut += header.size() + size;
+            continue;
+        }
+        
+        header.push_back(0);
+        uint8_t bitmap[32] = {};
+        for (int symbol = 0; symbol < 256; symbol++) {
+            if (lengths[symbol] > 0) bitmap[symbol / 8] |= (uint8_t)(1 << (symbol % 8));
+        }
+        header.insert(header.end(), bitmap, bitmap + 32);
+        uint8_t packed[256 * 5 / 8 + 8];
+        BitWriter lengthWriter(packed);
+        for (int symbol = 0; symbol < 256; symbol++) {
+            if (lengths[symbol] > 0) lengthWriter.write(lengths[symbol] - 1, 5);
+        }
+        header.insert(header.end(), packed, packed + (lengthWriter.finish() + 7) / 8);
+        putUint32(header, (uint32_t)payloadBytes);
         
-        if (node->isLeaf) {
-            cout << "Leaf: '" << node->data << "' (freq: " << node->frequency << ")" << endl;
+        writeExactly(out, header.data(), header.size());
+        writeExactly(out, payload.data(), payloadBytes);
+        stats.bytesOut += header.size() + payloadBytes;
+    }
+    
+    uint8_t endMarker[4] = {};
+    writeExactly(out, endMarker, 4);
+    stats.bytesOut += 4;
+    return stats;
+}
+
+// Decompress a compressStream stream from in to out block by block
+inline StreamStats decompressStream(FILE* in, FILE* out) {
+    StreamStats stats;
+    uint8_t magic[4];
+    if (readFully(in, magic, 4) != 4 || memcmp(magic, STREAM_MAGIC, 4) != 0) {
+        throw runtime_error("Not a Huffman-compressed stream");
+    }
+    stats.bytesIn += 4;
+    
+    vector<uint8_t> block(BLOCK_SIZE);
+    vector<uint8_t> payload;
+    while (true) {
+        uint8_t sizeBytes[4];
+        readExactly(in, sizeBytes, 4);
+        stats.bytesIn += 4;
+        uint32_t size = getUint32(sizeBytes);
+        if (size == 0) break;
+        if (size > BLOCK_SIZE) {
+            throw runtime_error("Corrupt block header");
+        }
+        
+        uint8_t type;
+        readExactly(in, &type, 1);
+        stats.bytesIn += 1;
+        if (type == 1) {
+            readExactly(in, block.data(), size);
+            stats.bytesIn += size;
+        } else if (type == 0) {
+            uint8_t bitmap[32];
+            readExactly(in, bitmap, 32);
+            int used = 0;
+            for (int symbol = 0; symbol < 256; symbol++) {
+                used += (bitmap[symbol / 8] >> (symbol % 8)) & 1;
+            }
+            
+            uint8_t packed[256 * 5 / 8 + 1];
+            size_t packedBytes = (used * 5 + 7) / 8;
+            readExactly(in, packed, packedBytes);
+            array<int, 256> lengths{};
+            int field = 0;
+            for (int symbol = 0; symbol < 256; symbol++) {
+                if (!((bitmap[symbol / 8] >> (symbol % 8)) & 1)) continue;
+                int value = 0;
+                for (int bit = 0; bit < 5; bit++, field++) {
+                    value = (value << 1) | ((packed[field / 8] >> (7 - field % 8)) & 1);
+                }
+                lengths[symbol] = value + 1;
+            }
+            
+            uint8_t payloadSize[4];
+            readExactly(in, payloadSize, 4);
+            uint32_t payloadBytes = getUint32(payloadSize);
+            if (payloadBytes > (uint64_t)size * 32 / 8 + 8) {
+                throw runtime_error("Corrupt block header");
+            }
+            payload.resize(payloadBytes);
+            readExactly(in, payload.data(), payloadBytes);
+            stats.bytesIn += 32 + packedBytes + 4 + payloadBytes;
+            
+            HuffmanDecoder decoder(lengths);
+            decoder.decode(payload.data(), payloadBytes, block.data(), size);
         } else {
-            cout << "Internal: (freq: " << node->frequency << ")" << endl;
+            throw runtime_error("Unknown block type");
         }
         
-        displayTree(node->left, indent + 1);
-        displayTree(node->right, indent + 1);
+        writeExactly(out, block.data(), size);
+        stats.bytesOut += size;
+    }
+    return stats;
+}
+
+// CLI entry for --compress [--max-length N] / --decompress [input [output]];
+// "-" or a missing name means stdin / stdout. Statistics go to stderr.
+int runStreamCommand(bool compress, const char* inputName, const char* outputName,
+                     int maxCodeLength = DEFAULT_MAX_CODE_LENGTH) {
+    bool useStdin = inputName == nullptr || string(inputName) == "-";
+    bool useStdout = outputName == nullptr || string(outputName) == "-";
+    FILE* in = useStdin ? stdin : fopen(inputName, "rb");
+    if (in == nullptr) {
+        cerr << "Error: cannot open " << inputName << endl;
+        return 1;
+    }
+    FILE* out = useStdout ? stdout : fopen(outputName, "wb");
+    if (out == nullptr) {
+        cerr << "Error: cannot create " << outputName << endl;
+        if (!useStdin) fclose(in);
+        return 1;
     }
     
-    HuffmanNode* getRoot() { return root; }
-};
+    int status = 0;
+    try {
+        auto startTime = chrono::steady_clock::now();
+        StreamStats stats = compress ? compressStream(in, out, maxCodeLength) : decompressStream(in, out);
+        if (fflush(out) != 0) {
+            throw runtime_error("Write failed");
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+        uint64_t rawBytes = compress ? stats.bytesIn : stats.bytesOut;
+        cerr << stats.bytesIn << " -> " << stats.bytesOut << " bytes";
+        if (stats.bytesIn > 0) {
+            cerr << " (" << fixed << setprecision(1) << 100.0 * stats.bytesOut / stats.bytesIn << "%)";
+        }
+        cerr << ", " << fixed << setprecision(1) << rawBytes / max(seconds, 1e-9) / 1e6 << " MB/s" << endl;
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        status = 1;
+    }
+    
+    if (!useStdin) fclose(in);
+    if (!useStdout && fclose(out) != 0) status = 1;
+    return status;
+}
 
 // Function to solve the given problem
 void solveHuffmanProblem(const string& characters, const vector<int>& frequencies) {
@@ -218,6 +1087,259 @@ void testAdditionalExamples() {
     solveHuffmanProblem(S3, f3);
 }
 
+// Compare code-length construction for large alphabets: a binary heap over a
+// pointer-free tree, huffmanCodeLengths (radix sort + in-place Moffat-Katajainen),
+// and moffatKatajainenInPlace alone on pre-sorted frequencies
+void runBuildBenchmark() {
+    cout << "\n=== Code Construction Benchmark ===" << endl;
+    cout << setw(8) << "symbols" << setw(14) << "heap us" << setw(14) << "radix+MK us" 
+         << setw(14) << "sorted MK us" << setw(16) << "encoded bits" << endl;
+    
+    // Average microseconds per call of f over enough calls to fill ~50 ms
+    auto timeMicros = [](auto f) {
+        int reps = 0;
+        auto startTime = chrono::steady_clock::now();
+        double elapsed = 0.0;
+        do {
+            f();
+            reps++;
+            elapsed = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+        } while (elapsed < 0.05);
+        return elapsed * 1e6 / reps;
+    };
+    
+    // Reference: heap-based Huffman construction, then leaf depths from parent links
+    auto heapCodeLengths = [](const vector<uint64_t>& frequencies) {
+        int n = (int)frequencies.size();
+        vector<int> parent(2 * n, -1);
+        priority_queue<pair<uint64_t, int>, vector<pair<uint64_t, int>>, greater<pair<uint64_t, int>>> minHeap;
+        for (int i = 0; i < n; i++) {
+            minHeap.push({frequencies[i], i});
+        }
+        int next = n;
+        while (minHeap.size() > 1) {
+            auto a = minHeap.top();
+            minHeap.pop();
+            auto b = minHeap.top();
+            minHeap.pop();
+            parent[a.second] = parent[b.second] = next;
+            minHeap.push({a.first + b.first, next++});
+        }
+        vector<int> depth(next, 0), lengths(n);
+        for (int node = next - 2; node >= 0; node--) {
+            depth[node] = depth[parent[node]] + 1;
+        }
+        copy(depth.begin(), depth.begin() + n, lengths.begin());
+        return lengths;
+    };
+    
+    mt19937 rng(42);
+    for (int n : {256, 4096, 65536}) {
+        // Zipf-like frequencies in random symbol order
+        vector<uint64_t> frequencies(n);
+        for (int i = 0; i < n; i++) {
+            frequencies[i] = 1 + 10000000 / (uint64_t)(i + 1);
+        }
+        shuffle(frequencies.begin(), frequencies.end(), rng);
+        vector<uint64_t> sortedFrequencies = frequencies;
+        sort(sortedFrequencies.begin(), sortedFrequencies.end());
+        
+        vector<int> heapLengths, radixLengths;
+        vector<uint64_t> work(n);
+        double heapTime = timeMicros([&]() { heapLengths = heapCodeLengths(frequencies); });
+        double radixTime = timeMicros([&]() { radixLengths = huffmanCodeLengths(frequencies); });
+        double sortedTime = timeMicros([&]() {
+            copy(sortedFrequencies.begin(), sortedFrequencies.end(), work.begin());
+            moffatKatajainenInPlace(work.data(), n);
+        });
+        
+        // Ties may be broken differently, but every method must reach the same cost
+        uint64_t heapBits = 0, radixBits = 0, sortedBits = 0;
+        for (int i = 0; i < n; i++) {
+            heapBits += frequencies[i] * heapLengths[i];
+            radixBits += frequencies[i] * radixLengths[i];
+            sortedBits += sortedFrequencies[i] * work[i];
+        }
+        cout << setw(8) << n << fixed << setprecision(1) << setw(14) << heapTime << setw(14) << radixTime 
+             << setw(14) << sortedTime << setw(16) << radixBits 
+             << (heapBits == radixBits && radixBits == sortedBits ? "" : "  MISMATCH") << endl;
+    }
+}
+
+// Synthetic log-like text: bytes drawn from a skewed (geometric) distribution
+// over the printable characters, so the entropy is a few bits per byte
+string syntheticText(size_t n, unsigned seed) {
+    mt19937 rng(seed);
+    geometric_distribution<int> dist(0.12);
+    string text(n, ' ');
+    for (size_t i = 0; i < n; i++) {
+        text[i] = (char)(' ' + dist(rng) % 95);
+    }
+    return text;
+}
+
+// Build a HuffmanCoding for the byte frequencies of text, optionally with
+// codes limited to maxCodeLength bits
+HuffmanCoding codingForText(const string& text, int maxCodeLength = 0) {
+    vector<int> counts(256, 0);
+    for (unsigned char c : text) counts[c]++;
+    string characters;
+    vector<int> frequencies;
+    for (int symbol = 0; symbol < 256; symbol++) {
+        if (counts[symbol] > 0) {
+            characters.push_back((char)symbol);
+            frequencies.push_back(counts[symbol]);
+        }
+    }
+    HuffmanCoding huffman;
+    huffman.setMaxCodeLength(maxCodeLength);
+    huffman.buildTree(characters, frequencies);
+    return huffman;
+}
+
+// Encoding throughput: '0'/'1' string concatenation (the old map<char, string>
+// approach) against the canonical code table with the 64-bit BitWriter
+void runEncodeBenchmark() {
+    cout << "\n=== Encoder Benchmark ===" << endl;
+    const size_t n = 64 << 20;
+    string text = syntheticText(n, 7);
+    HuffmanCoding huffman = codingForText(text);
+    
+    // Baseline on a 4 MB prefix: one heap string per code, appended bit by bit
+    const size_t baselineBytes = 4 << 20;
+    map<char, string> stringCodes;
+    for (int symbol = 0; symbol < 256; symbol++) {
+        if (huffman.getCanonicalCodes()[symbol].length > 0) {
+            stringCodes[(char)symbol] = huffman.getCode((char)symbol);
+        }
+    }
+    auto startTime = chrono::steady_clock::now();
+    string bitText;
+    for (size_t i = 0; i < baselineBytes; i++) {
+        bitText += stringCodes[text[i]];
+    }
+    double baseline = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    
+    vector<uint8_t> out(huffman.maxEncodedBytes(n));
+    startTime = chrono::steady_clock::now();
+    uint64_t bits = huffman.encode((const uint8_t*)text.data(), n, out.data());
+    double tableTime = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    
+    // The packed prefix must match the '0'/'1' text bit for bit
+    bool match = true;
+    for (size_t i = 0; i < bitText.size() && match; i++) {
+        match = ((out[i / 8] >> (7 - i % 8)) & 1) == (uint64_t)(bitText[i] == '1');
+    }
+    
+    cout << fixed << setprecision(1);
+    cout << "Input: " << n / 1048576 << " MB, " << (double)bits / n << " bits/byte" << endl;
+    cout << "String concatenation: " << baselineBytes / baseline / 1e6 << " MB/s" << endl;
+    cout << "Canonical table + 64-bit bit buffer: " << n / tableTime / 1e6 << " MB/s" 
+         << (match ? "" : "  MISMATCH") << endl;
+}
+
+// Decoding throughput: walking the tree one bit at a time against the
+// table-driven HuffmanDecoder, with a round-trip check
+void runDecodeBenchmark() {
+    cout << "\n=== Decoder Benchmark ===" << endl;
+    const size_t n = 64 << 20;
+    string text = syntheticText(n, 7);
+    HuffmanCoding huffman = codingForText(text);
+    vector<uint8_t> encoded = huffman.encode(text);
+    HuffmanDecoder decoder(huffman.getCodeLengths());
+    
+    // Baseline on a 4 MB prefix: one tree step per bit over a tree rebuilt from
+    // the canonical codes (node 0 is the root, child index 0 means none)
+    const size_t baselineBytes = 4 << 20;
+    vector<array<int, 2>> tree(1, {0, 0});
+    vector<int> leafSymbol(1, -1);
+    for (int symbol = 0; symbol < 256; symbol++) {
+        const HuffmanCode& code = huffman.getCanonicalCodes()[symbol];
+        int node = 0;
+        for (int i = code.length - 1; i >= 0; i--) {
+            int bit = (code.bits >> i) & 1;
+            if (tree[node][bit] == 0) {
+                tree[node][bit] = (int)tree.size();
+                tree.push_back({0, 0});
+                leafSymbol.push_back(-1);
+            }
+            node = tree[node][bit];
+        }
+        if (code.length > 0) leafSymbol[node] = symbol;
+    }
+    auto startTime = chrono::steady_clock::now();
+    string walked(baselineBytes, '\0');
+    uint64_t pos = 0;
+    for (size_t i = 0; i < baselineBytes; i++) {
+        int node = 0;
+        while (leafSymbol[node] < 0) {
+            node = tree[node][(encoded[pos / 8] >> (7 - pos % 8)) & 1];
+            pos++;
+        }
+        walked[i] = (char)leafSymbol[node];
+    }
+    double baseline = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    
+    string decoded(n, '\0');
+    startTime = chrono::steady_clock::now();
+    decoder.decode(encoded.data(), encoded.size(), (uint8_t*)decoded.data(), n);
+    double tableTime = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    
+    bool match = decoded == text && walked == text.substr(0, baselineBytes);
+    cout << fixed << setprecision(1);
+    cout << "Input: " << n / 1048576 << " MB, " << 8.0 * encoded.size() / n << " bits/byte" << endl;
+    cout << "Bit-by-bit tree walk: " << baselineBytes / baseline / 1e6 << " MB/s" << endl;
+    cout << "Table-driven decoder: " << n / tableTime / 1e6 << " MB/s" 
+         << (match ? "" : "  MISMATCH") << endl;
+}
+
+// Cost of length limits: compressed size and table-decoder throughput with no
+// limit and with 15, 12 and 11 bits, on text whose byte counts fall off
+// geometrically (ratio 0.6) so the unlimited code is over 30 bits deep
+void runLengthLimitBenchmark() {
+    cout << "\n=== Length-Limited Code Benchmark ===" << endl;
+    const size_t n = 32 << 20;
+    string text;
+    text.reserve(n);
+    for (int symbol = 1; symbol < 256; symbol++) {
+        size_t count = max<size_t>(1, (size_t)(n * 0.4 * pow(0.6, symbol)));
+        text.append(count, (char)symbol);
+    }
+    text.insert(0, n - text.size(), '\0');
+    shuffle(text.begin(), text.end(), mt19937(11));
+    
+    vector<uint64_t> frequencies(256, 0);
+    for (unsigned char c : text) frequencies[c]++;
+    
+    cout << fixed;
+    cout << "Input: " << n / 1048576 << " MB, 256 symbols" << endl;
+    for (int limit : {0, 15, 12, 11}) {
+        HuffmanCoding huffman = codingForText(text, limit);
+        array<int, 256> lengths = huffman.getCodeLengths();
+        int longest = *max_element(lengths.begin(), lengths.end());
+        
+        auto startTime = chrono::steady_clock::now();
+        const int repeats = 1000;
+        for (int r = 0; r < repeats && limit > 0; r++) {
+            lengthLimitedCodeLengths(frequencies, limit);
+        }
+        double lengthTime = chrono::duration<double>(chrono::steady_clock::now() - startTime).count() / repeats;
+        
+        vector<uint8_t> encoded = huffman.encode(text);
+        HuffmanDecoder decoder(lengths);
+        string decoded(n, '\0');
+        startTime = chrono::steady_clock::now();
+        decoder.decode(encoded.data(), encoded.size(), (uint8_t*)decoded.data(), n);
+        double decodeTime = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+        
+        cout << (limit > 0 ? "Limit " + to_string(limit) : string("Unlimited")) << ": max " << longest << " bits, "
+             << setprecision(4) << 8.0 * encoded.size() / n << " bits/byte, decode "
+             << setprecision(1) << n / decodeTime / 1e6 << " MB/s";
+        if (limit > 0) cout << ", package-merge " << setprecision(1) << lengthTime * 1e6 << " us";
+        cout << (decoded == text ? "" : "  MISMATCH") << endl;
+    }
+}
+
 // Interactive mode for user input
 void interactiveMode() {
     cout << "\n=== Interactive Mode ===" << endl;
@@ -236,7 +1358,35 @@ void interactiveMode() {
     solveHuffmanProblem(characters, frequencies);
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench-build") {
+        runBuildBenchmark();
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-encode") {
+        runEncodeBenchmark();
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-decode") {
+        runDecodeBenchmark();
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-limit") {
+        runLengthLimitBenchmark();
+        return 0;
+    }
+    if (argc > 1 && (string(argv[1]) == "--compress" || string(argv[1]) == "--decompress")) {
+        bool compress = string(argv[1]) == "--compress";
+        int maxCodeLength = DEFAULT_MAX_CODE_LENGTH;
+        int next = 2;
+        if (compress && argc > 3 && string(argv[2]) == "--max-length") {
+            maxCodeLength = atoi(argv[3]);
+            next = 4;
+        }
+        return runStreamCommand(compress, argc > next ? argv[next] : nullptr,
+                                argc > next + 1 ? argv[next + 1] : nullptr, maxCodeLength);
+    }
+    
     cout << "Huffman Coding Implementation" << endl;
     cout << "============================" << endl;
     
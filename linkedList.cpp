@@ -1,281 +1,8 @@
 #include <iostream>
-#include <vector>
-#include <stdexcept>
+#include <cstdio>
+#include "linkedList.h"
 using namespace std;
 
-// Node structure to represent a non-zero element in the sparse matrix
-struct Node {
-    int row;
-    int col;
-    double value;
-    Node* next;
-    
-    // Constructor
-    Node(int r, int c, double v) : row(r), col(c), value(v), next(nullptr) {}
-};
-
-// SparseMatrix class using LinkedList implementation
-class SparseMatrix {
-private:
-    int rows;
-    int cols;
-    Node* head; // Head of the linked list
-    
-public:
-    // Constructor
-    SparseMatrix(int r, int c) : rows(r), cols(c), head(nullptr) {}
-    
-    // Destructor
-    ~SparseMatrix() {
-        clear();
-    }
-    
-    // Copy constructor
-    SparseMatrix(const SparseMatrix& other) : rows(other.rows), cols(other.cols), head(nullptr) {
-        Node* current = other.head;
-        while (current != nullptr) {
-            insert(current->row, current->col, current->value);
-            current = current->next;
-        }
-    }
-    
-    // Assignment operator
-    SparseMatrix& operator=(const SparseMatrix& other) {
-        if (this != &other) {
-            clear();
-            rows = other.rows;
-            cols = other.cols;
-            Node* current = other.head;
-            while (current != nullptr) {
-                insert(current->row, current->col, current->value);
-                current = current->next;
-            }
-        }
-        return *this;
-    }
-    
-    // Insert a value at given position
-    void insert(int row, int col, double value) {
-        if (row < 0 || row >= rows || col < 0 || col >= cols) {
-            throw out_of_range("Index out of bounds");
-        }
-        
-        // If value is zero, remove the node if it exists
-        if (value == 0.0) {
-            remove(row, col);
-            return;
-        }
-        
-        // If list is empty, insert at head
-        if (head == nullptr) {
-            head = new Node(row, col, value);
-            return;
-        }
-        
-        // If new node should be inserted before head
-        if (row < head->row || (row == head->row && col < head->col)) {
-            Node* newNode = new Node(row, col, value);
-            newNode->next = head;
-            head = newNode;
-            return;
-        }
-        
-        // If head has same position, update value
-        if (row == head->row && col == head->col) {
-            head->value = value;
-            return;
-        }
-        
-        // Find the correct position to insert
-        Node* current = head;
-        while (current->next != nullptr) {
-            if (row < current->next->row || 
-                (row == current->next->row && col < current->next->col)) {
-                break;
-            }
-            if (row == current->next->row && col == current->next->col) {
-                current->next->value = value;
-                return;
-            }
-            current = current->next;
-        }
-        
-        // Insert new node
-        Node* newNode = new Node(row, col, value);
-        newNode->next = current->next;
-        current->next = newNode;
-    }
-    
-    // Get value at given position
-    double get(int row, int col) const {
-        if (row < 0 || row >= rows || col < 0 || col >= cols) {
-            throw out_of_range("Index out of bounds");
-        }
-        
-        Node* current = head;
-        while (current != nullptr) {
-            if (current->row == row && current->col == col) {
-                return current->value;
-            }
-            if (current->row > row || (current->row == row && current->col > col)) {
-                break;
-            }
-            current = current->next;
-        }
-        return 0.0; // Default value for sparse matrix
-    }
-    
-    // Set value at given position (alias for insert)
-    void set(int row, int col, double value) {
-        insert(row, col, value);
-    }
-    
-    // Remove a node at given position
-    void remove(int row, int col) {
-        if (head == nullptr) return;
-        
-        // If head is the node to remove
-        if (head->row == row && head->col == col) {
-            Node* temp = head;
-            head = head->next;
-            delete temp;
-            return;
-        }
-        
-        // Find and remove the node
-        Node* current = head;
-        while (current->next != nullptr) {
-            if (current->next->row == row && current->next->col == col) {
-                Node* temp = current->next;
-                current->next = current->next->next;
-                delete temp;
-                return;
-            }
-            current = current->next;
-        }
-    }
-    
-    // Add two sparse matrices
-    SparseMatrix add(const SparseMatrix& other) const {
-        if (rows != other.rows || cols != other.cols) {
-            throw invalid_argument("Matrix dimensions must match for addition");
-        }
-        
-        SparseMatrix result(rows, cols);
-        
-        // Copy all elements from this matrix
-        Node* current = head;
-        while (current != nullptr) {
-            result.insert(current->row, current->col, current->value);
-            current = current->next;
-        }
-        
-        // Add elements from other matrix
-        current = other.head;
-        while (current != nullptr) {
-            double currentValue = result.get(current->row, current->col);
-            result.insert(current->row, current->col, currentValue + current->value);
-            current = current->next;
-        }
-        
-        return result;
-    }
-    
-    // Multiply two sparse matrices
-    SparseMatrix multiply(const SparseMatrix& other) const {
-        if (cols != other.rows) {
-            throw invalid_argument("Matrix dimensions incompatible for multiplication");
-        }
-        
-        SparseMatrix result(rows, other.cols);
-        
-        // For each non-zero element in this matrix
-        Node* current = head;
-        while (current != nullptr) {
-            // For each non-zero element in other matrix
-            Node* otherCurrent = other.head;
-            while (otherCurrent != nullptr) {
-                if (current->col == otherCurrent->row) {
-                    double product = current->value * otherCurrent->value;
-                    double existingValue = result.get(current->row, otherCurrent->col);
-                    result.insert(current->row, otherCurrent->col, existingValue + product);
-                }
-                otherCurrent = otherCurrent->next;
-            }
-            current = current->next;
-        }
-        
-        return result;
-    }
-    
-    // Transpose the matrix
-    SparseMatrix transpose() const {
-        SparseMatrix result(cols, rows);
-        
-        Node* current = head;
-        while (current != nullptr) {
-            result.insert(current->col, current->row, current->value);
-            current = current->next;
-        }
-        
-        return result;
-    }
-    
-    // Display the matrix
-    void display() const {
-        cout << "Sparse Matrix (" << rows << "x" << cols << "):" << endl;
-        for (int i = 0; i < rows; i++) {
-            for (int j = 0; j < cols; j++) {
-                cout << get(i, j) << "\t";
-            }
-            cout << endl;
-        }
-        cout << endl;
-    }
-    
-    // Display only non-zero elements
-    void displaySparse() const {
-        cout << "Non-zero elements:" << endl;
-        Node* current = head;
-        while (current != nullptr) {
-            cout << "(" << current->row << ", " << current->col << ") = " 
-                 << current->value << endl;
-            current = current->next;
-        }
-        cout << endl;
-    }
-    
-    // Get number of non-zero elements
-    int getNonZeroCount() const {
-        int count = 0;
-        Node* current = head;
-        while (current != nullptr) {
-            count++;
-            current = current->next;
-        }
-        return count;
-    }
-    
-    // Check if matrix is empty (all zeros)
-    bool isEmpty() const {
-        return head == nullptr;
-    }
-    
-    // Clear all elements
-    void clear() {
-        while (head != nullptr) {
-            Node* temp = head;
-            head = head->next;
-            delete temp;
-        }
-    }
-    
-    // Get matrix dimensions
-    pair<int, int> getDimensions() const {
-        return make_pair(rows, cols);
-    }
-};
-
 // Test function
 void runTests() {
     cout << "=== Sparse Matrix LinkedList Implementation Tests ===" << endl << endl;
@@ -306,6 +33,10 @@ void runTests() {
     SparseMatrix sum = matrix1.add(matrix2);
     cout << "Sum (Matrix1 + Matrix2):" << endl;
     sum.display();
+    
+    SparseMatrix combination = matrix1.axpby(2.0, -1.0, matrix2);
+    cout << "2 * Matrix1 - Matrix2:" << endl;
+    combination.display();
     cout << endl;
     
     // Test 3: Matrix multiplication
@@ -373,6 +104,55 @@ void runTests() {
         cout << "Caught expected error: " << e.what() << endl;
     }
     cout << endl;
+    
+    // Test 7: Node pool reuse
+    cout << "Test 7: Node Pool" << endl;
+    SparseMatrix pooled(100, 100);
+    for (int i = 0; i < 100; i++) {
+        pooled.insert(i, (i * 7) % 100, i + 1.0);
+    }
+    size_t before = pooled.getMemoryUsage();
+    for (int i = 0; i < 100; i += 2) {
+        pooled.remove(i, (i * 7) % 100);
+    }
+    for (int i = 0; i < 100; i += 2) {
+        pooled.insert(i, (i * 3) % 100, 1.0);
+    }
+    cout << "Removed nodes reused: " << (pooled.getMemoryUsage() == before ? "true" : "false") << endl;
+    pooled.clear();
+    cout << "Cleared matrix is empty: " << (pooled.isEmpty() ? "true" : "false") << endl;
+    pooled.insert(5, 5, 2.5);
+    cout << "Insert after clear: " << pooled.get(5, 5) << endl << endl;
+    
+    // Test 8: File round trips
+    cout << "Test 8: Matrix Market and Binary I/O" << endl;
+    matrix1.writeMatrixMarket("linked_list_test.mtx");
+    matrix1.writeBinary("linked_list_test.csr");
+    SparseMatrix fromMtx = SparseMatrix::readMatrixMarket("linked_list_test.mtx");
+    SparseMatrix fromBinary = SparseMatrix::readBinary("linked_list_test.csr");
+    cout << "Matrix Market round trip:" << endl;
+    fromMtx.displaySparse();
+    cout << "Binary round trip non-zeros: " << fromBinary.getNonZeroCount() << endl;
+    std::remove("linked_list_test.mtx");
+    std::remove("linked_list_test.csr");
+    
+    try {
+        SparseMatrix::readMatrixMarket("missing_file.mtx");
+    } catch (const runtime_error& e) {
+        cout << "Caught expected error: " << e.what() << endl;
+    }
+    cout << endl;
+    
+    // Test 9: Generic algorithms shared by every backend
+    cout << "Test 9: Generic Algorithms" << endl;
+    cout << "Transpose twice equals original: " 
+         << (sparseEqual(matrix1.transpose().transpose(), matrix1) ? "true" : "false") << endl;
+    cout << "Equal to a different matrix: " 
+         << (sparseEqual(matrix1, matrix2) ? "true" : "false") << endl;
+    cout << "Frobenius norm of Matrix 1: " << frobeniusNorm(matrix1) << endl;
+    vector<double> ones(3, 1.0), rowSums(3);
+    sparseMultiply(matrix1, ones.data(), rowSums.data());
+    cout << "Row sums: [" << rowSums[0] << " " << rowSums[1] << " " << rowSums[2] << "]" << endl << endl;
 }
 
 int main() {
@@ -0,0 +1,745 @@
+#ifndef LINKED_LIST_H
+#define LINKED_LIST_H
+
+// Linked-list sparse matrix (SparseMatrix) with its node pool.
+
+#include <iostream>
+#include <vector>
+#include <stdexcept>
+#include <new>
+#include <algorithm>
+#include <cstdio>
+#include "sparse_io.h"
+#include "sparseMatrix.h"
+
+// Node structure to represent a non-zero element in the sparse matrix
+template <typename Value, typename Index>
+struct BasicNode {
+    Index row;
+    Index col;
+    Value value;
+    BasicNode* next; // Next non-zero in the same row
+    BasicNode* down; // Next non-zero in the same column
+    
+    // Constructor
+    BasicNode(Index r, Index c, Value v) : row(r), col(c), value(v), next(nullptr), down(nullptr) {}
+};
+
+using Node = BasicNode<double, int>;
+
+// NodePool class: slab allocator for the Nodes of one matrix. Nodes are carved
+// from contiguous slabs that double in size, removed nodes are kept on a free
+// list for reuse, and release() drops every node at once.
+template <typename Value, typename Index>
+class BasicNodePool {
+    using Node = BasicNode<Value, Index>;
+    
+private:
+    static constexpr int FIRST_SLAB_NODES = 64;
+    static constexpr int MAX_SLAB_NODES = 1 << 16;
+    
+    std::vector<Node*> slabs;   // Raw storage, one entry per slab
+    Node* freeList;        // Removed nodes, chained through next
+    int slabUsed;          // Nodes handed out from the newest slab
+    int slabCapacity;      // Size of the newest slab
+    
+    void addSlab() {
+        int nodes = slabs.empty() ? FIRST_SLAB_NODES : std::min(slabCapacity * 2, MAX_SLAB_NODES);
+        slabs.push_back(static_cast<Node*>(::operator new(sizeof(Node) * nodes)));
+        slabCapacity = nodes;
+        slabUsed = 0;
+    }
+    
+public:
+    BasicNodePool() : freeList(nullptr), slabUsed(0), slabCapacity(0) {}
+    
+    ~BasicNodePool() {
+        release();
+    }
+    
+    // A pool owns its nodes, so it cannot be copied
+    BasicNodePool(const BasicNodePool&) = delete;
+    BasicNodePool& operator=(const BasicNodePool&) = delete;
+    
+    // Moving hands every slab over; the source is left empty
+    BasicNodePool(BasicNodePool&& other) noexcept
+        : slabs(std::move(other.slabs)), freeList(other.freeList), 
+          slabUsed(other.slabUsed), slabCapacity(other.slabCapacity) {
+        other.slabs.clear();
+        other.freeList = nullptr;
+        other.slabUsed = 0;
+        other.slabCapacity = 0;
+    }
+    
+    BasicNodePool& operator=(BasicNodePool&& other) noexcept {
+        if (this != &other) {
+            release();
+            slabs = std::move(other.slabs);
+            freeList = other.freeList;
+            slabUsed = other.slabUsed;
+            slabCapacity = other.slabCapacity;
+            other.slabs.clear();
+            other.freeList = nullptr;
+            other.slabUsed = 0;
+            other.slabCapacity = 0;
+        }
+        return *this;
+    }
+    
+    // Construct a node, reusing a removed one when available
+    Node* allocate(Index r, Index c, Value v) {
+        void* memory;
+        if (freeList != nullptr) {
+            memory = freeList;
+            freeList = freeList->next;
+        } else {
+            if (slabUsed == slabCapacity) {
+                addSlab();
+            }
+            memory = slabs.back() + slabUsed++;
+        }
+        return new (memory) Node(r, c, v);
+    }
+    
+    // Return a node for reuse (Node is trivially destructible)
+    void deallocate(Node* node) {
+        node->next = freeList;
+        freeList = node;
+    }
+    
+    // Free every node at once
+    void release() {
+        for (Node* slab : slabs) {
+            ::operator delete(slab);
+        }
+        slabs.clear();
+        freeList = nullptr;
+        slabUsed = 0;
+        slabCapacity = 0;
+    }
+    
+    // Bytes held by the slabs
+    size_t getMemoryUsage() const {
+        size_t nodes = 0;
+        int capacity = FIRST_SLAB_NODES;
+        for (size_t i = 0; i < slabs.size(); i++) {
+            nodes += capacity;
+            capacity = std::min(capacity * 2, MAX_SLAB_NODES);
+        }
+        return nodes * sizeof(Node) + slabs.capacity() * sizeof(Node*);
+    }
+};
+
+using NodePool = BasicNodePool<double, int>;
+
+// BasicSparseMatrix class using an orthogonal linked list: every row and every
+// column has its own sorted list, so point access costs O(row nnz) and row or
+// column traversals start directly at their head. Values and indices are
+// parameterised like BasicCSRMatrix.
+template <typename Value, typename Index>
+class BasicSparseMatrix {
+    static_assert(isSparseValue<Value>::value, "Value type must be float, double or int");
+    static_assert(isSparseIndex<Index>::value, "Index type must be int, uint32_t or uint64_t");
+    
+public:
+    using Node = BasicNode<Value, Index>;
+    
+private:
+    Index rows;
+    Index cols;
+    Index count;                      // Number of non-zero elements
+    std::vector<Node*> rowHeads;           // First node of each row, linked by next
+    std::vector<Node*> colHeads;           // First node of each column, linked by down
+    BasicNodePool<Value, Index> pool; // Owns every node of this matrix
+    
+    // Append a node at the end of its row and column; nodes must arrive in
+    // (row, col) order so both lists stay sorted. rowTails/colTails track the ends.
+    void appendInOrder(Index row, Index col, Value value, 
+                       std::vector<Node*>& rowTails, std::vector<Node*>& colTails) {
+        Node* node = pool.allocate(row, col, value);
+        if (rowTails[row] == nullptr) {
+            rowHeads[row] = node;
+        } else {
+            rowTails[row]->next = node;
+        }
+        rowTails[row] = node;
+        
+        if (colTails[col] == nullptr) {
+            colHeads[col] = node;
+        } else {
+            colTails[col]->down = node;
+        }
+        colTails[col] = node;
+        count++;
+    }
+    
+    // Reset a moved-from matrix to 0x0 without allocating
+    void leaveEmpty() noexcept {
+        rows = 0;
+        cols = 0;
+        count = 0;
+        rowHeads.clear();
+        colHeads.clear();
+    }
+    
+    // Rebuild this (empty) matrix from another one's nodes
+    void copyNodes(const BasicSparseMatrix& other) {
+        std::vector<Node*> rowTails(rows, nullptr);
+        std::vector<Node*> colTails(cols, nullptr);
+        for (Index r = 0; r < other.rows; r++) {
+            for (Node* current = other.rowHeads[r]; current != nullptr; current = current->next) {
+                appendInOrder(current->row, current->col, current->value, rowTails, colTails);
+            }
+        }
+    }
+    
+public:
+    using value_type = Value;
+    using index_type = Index;
+    
+    // Constructor
+    BasicSparseMatrix(Index r, Index c) 
+        : rows(r), cols(c), count(0), rowHeads(r, nullptr), colHeads(c, nullptr) {}
+    
+    // Destructor
+    ~BasicSparseMatrix() {
+        clear();
+    }
+    
+    // Copy constructor
+    BasicSparseMatrix(const BasicSparseMatrix& other) 
+        : rows(other.rows), cols(other.cols), count(0), 
+          rowHeads(other.rows, nullptr), colHeads(other.cols, nullptr) {
+        copyNodes(other);
+    }
+    
+    // Assignment operator
+    BasicSparseMatrix& operator=(const BasicSparseMatrix& other) {
+        if (this != &other) {
+            clear();
+            rows = other.rows;
+            cols = other.cols;
+            rowHeads.assign(rows, nullptr);
+            colHeads.assign(cols, nullptr);
+            copyNodes(other);
+        }
+        return *this;
+    }
+    
+    // Move constructor (takes over the nodes; other is left as an empty 0x0 matrix)
+    BasicSparseMatrix(BasicSparseMatrix&& other) noexcept
+        : rows(other.rows), cols(other.cols), count(other.count), 
+          rowHeads(std::move(other.rowHeads)), colHeads(std::move(other.colHeads)), 
+          pool(std::move(other.pool)) {
+        other.leaveEmpty();
+    }
+    
+    // Move assignment operator
+    BasicSparseMatrix& operator=(BasicSparseMatrix&& other) noexcept {
+        if (this != &other) {
+            rows = other.rows;
+            cols = other.cols;
+            count = other.count;
+            rowHeads = std::move(other.rowHeads);
+            colHeads = std::move(other.colHeads);
+            pool = std::move(other.pool);
+            other.leaveEmpty();
+        }
+        return *this;
+    }
+    
+    // Constructor evaluating a lazy expression (see sparseMatrix.h) in one pass,
+    // e.g. SparseMatrix c = a + 2.0 * transpose(b); nodes arrive in order, so
+    // each is appended in O(1)
+    template <typename Expr, typename = std::enable_if_t<isSparseExpression<Expr>::value>>
+    BasicSparseMatrix(const Expr& expr)
+        : BasicSparseMatrix((Index)expr.getDimensions().first, (Index)expr.getDimensions().second) {
+        std::vector<Node*> rowTails(rows, nullptr);
+        std::vector<Node*> colTails(cols, nullptr);
+        evaluateSparseExpression(expr, [&](size_t row, size_t col, Value value) {
+            appendInOrder((Index)row, (Index)col, value, rowTails, colTails);
+        });
+    }
+    
+    // Assign a lazy expression; it may refer to this matrix, so the result is
+    // built separately and then moved in
+    template <typename Expr, typename = std::enable_if_t<isSparseExpression<Expr>::value>>
+    BasicSparseMatrix& operator=(const Expr& expr) {
+        return *this = BasicSparseMatrix(expr);
+    }
+    
+    // Insert a value at given position
+    void insert(Index row, Index col, Value value) {
+        if (isNegativeIndex(row) || row >= rows || isNegativeIndex(col) || col >= cols) {
+            throw std::out_of_range("Index out of bounds");
+        }
+        
+        // If value is zero, remove the node if it exists
+        if (value == Value(0)) {
+            remove(row, col);
+            return;
+        }
+        
+        // Find the position in the row list
+        Node** rowLink = &rowHeads[row];
+        while (*rowLink != nullptr && (*rowLink)->col < col) {
+            rowLink = &(*rowLink)->next;
+        }
+        
+        // If a node already has this position, update value
+        if (*rowLink != nullptr && (*rowLink)->col == col) {
+            (*rowLink)->value = value;
+            return;
+        }
+        
+        // Find the position in the column list
+        Node** colLink = &colHeads[col];
+        while (*colLink != nullptr && (*colLink)->row < row) {
+            colLink = &(*colLink)->down;
+        }
+        
+        // Insert new node into both lists
+        Node* newNode = pool.allocate(row, col, value);
+        newNode->next = *rowLink;
+        *rowLink = newNode;
+        newNode->down = *colLink;
+        *colLink = newNode;
+        count++;
+    }
+    
+    // Get value at given position
+    Value get(Index row, Index col) const {
+        if (isNegativeIndex(row) || row >= rows || isNegativeIndex(col) || col >= cols) {
+            throw std::out_of_range("Index out of bounds");
+        }
+        
+        for (Node* current = rowHeads[row]; current != nullptr; current = current->next) {
+            if (current->col == col) {
+                return current->value;
+            }
+            if (current->col > col) {
+                break;
+            }
+        }
+        return Value(0); // Default value for sparse matrix
+    }
+    
+    // Set value at given position (alias for insert)
+    void set(Index row, Index col, Value value) {
+        insert(row, col, value);
+    }
+    
+    // Remove a node at given position
+    void remove(Index row, Index col) {
+        if (isNegativeIndex(row) || row >= rows || isNegativeIndex(col) || col >= cols) return;
+        
+        // Unlink from the row list
+        Node** rowLink = &rowHeads[row];
+        while (*rowLink != nullptr && (*rowLink)->col < col) {
+            rowLink = &(*rowLink)->next;
+        }
+        if (*rowLink == nullptr || (*rowLink)->col != col) return;
+        Node* temp = *rowLink;
+        *rowLink = temp->next;
+        
+        // Unlink from the column list
+        Node** colLink = &colHeads[col];
+        while (*colLink != temp) {
+            colLink = &(*colLink)->down;
+        }
+        *colLink = temp->down;
+        
+        pool.deallocate(temp);
+        count--;
+    }
+    
+    // Read a coordinate Matrix Market file. Entries are collected, sorted and
+    // summed once, then appended in order instead of inserted one by one.
+    static BasicSparseMatrix readMatrixMarket(const std::string& filename) {
+        static_assert(std::is_same<Value, double>::value && std::is_same<Index, int>::value,
+                      "Matrix Market files are read as double values with int indices");
+        struct Entry {
+            int row;
+            int col;
+            double value;
+        };
+        std::vector<Entry> entries;
+        int r = 0, c = 0;
+        sparse_io::readMatrixMarket(filename,
+            [&](const sparse_io::MatrixMarketHeader& header) {
+                r = header.rows;
+                c = header.cols;
+                bool mirrored = header.symmetric || header.skewSymmetric;
+                entries.reserve((size_t)header.entries * (mirrored ? 2 : 1));
+            },
+            [&](int row, int col, double value) {
+                entries.push_back({row, col, value});
+            });
+        
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+            return a.row < b.row || (a.row == b.row && a.col < b.col);
+        });
+        
+        BasicSparseMatrix result(r, c);
+        std::vector<Node*> rowTails(r, nullptr);
+        std::vector<Node*> colTails(c, nullptr);
+        size_t i = 0;
+        while (i < entries.size()) {
+            double sum = 0.0;
+            size_t j = i;
+            while (j < entries.size() && entries[j].row == entries[i].row && 
+                   entries[j].col == entries[i].col) {
+                sum += entries[j].value;
+                j++;
+            }
+            if (sum != 0.0) {
+                result.appendInOrder(entries[i].row, entries[i].col, sum, rowTails, colTails);
+            }
+            i = j;
+        }
+        return result;
+    }
+    
+    // Write as a general coordinate Matrix Market file
+    void writeMatrixMarket(const std::string& filename) const {
+        static_assert(std::is_same<Value, double>::value && std::is_same<Index, int>::value,
+                      "Matrix Market files are written from double values with int indices");
+        sparse_io::MatrixMarketWriter writer(filename, rows, cols, count);
+        for (Index i = 0; i < rows; i++) {
+            for (Node* current = rowHeads[i]; current != nullptr; current = current->next) {
+                writer.write(current->row, current->col, current->value);
+            }
+        }
+        writer.close();
+    }
+    
+    // Write in the binary CSR format (see sparse_io.h)
+    void writeBinary(const std::string& filename) const {
+        static_assert(std::is_same<Value, double>::value && std::is_same<Index, int>::value,
+                      "Binary CSR files hold double values with int indices");
+        std::vector<int> rowPtr(rows + 1, 0);
+        std::vector<int> colIdx;
+        std::vector<double> values;
+        colIdx.reserve(count);
+        values.reserve(count);
+        for (int i = 0; i < rows; i++) {
+            for (Node* current = rowHeads[i]; current != nullptr; current = current->next) {
+                colIdx.push_back(current->col);
+                values.push_back(current->value);
+            }
+            rowPtr[i + 1] = (int)colIdx.size();
+        }
+        sparse_io::writeBinaryCSR(filename, rows, cols, rowPtr.data(), colIdx.data(), values.data());
+    }
+    
+    // Load a binary CSR file (validated by MappedCSRFile) through mmap, appending
+    // nodes in row order
+    static BasicSparseMatrix readBinary(const std::string& filename) {
+        static_assert(std::is_same<Value, double>::value && std::is_same<Index, int>::value,
+                      "Binary CSR files hold double values with int indices");
+        sparse_io::MappedCSRFile file(filename);
+        const int* rowPtr = file.getRowPointers();
+        const int* colIdx = file.getColumnIndices();
+        const double* values = file.getValues();
+        
+        BasicSparseMatrix result(file.getRows(), file.getCols());
+        std::vector<Node*> rowTails(result.rows, nullptr);
+        std::vector<Node*> colTails(result.cols, nullptr);
+        for (int i = 0; i < result.rows; i++) {
+            for (int k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+                if (values[k] != 0.0) {
+                    result.appendInOrder(i, colIdx[k], values[k], rowTails, colTails);
+                }
+            }
+        }
+        return result;
+    }
+    
+    // Sparse matrix-vector product y = A * x (x has cols entries, y has rows entries)
+    void multiply(const Value* x, Value* y) const {
+        for (Index i = 0; i < rows; i++) {
+            Value sum = Value(0);
+            for (Node* current = rowHeads[i]; current != nullptr; current = current->next) {
+                sum += current->value * x[current->col];
+            }
+            y[i] = sum;
+        }
+    }
+    
+    // Get the first node of a row (follow next for the rest)
+    const Node* getRow(Index row) const {
+        if (isNegativeIndex(row) || row >= rows) {
+            throw std::out_of_range("Row index out of bounds");
+        }
+        return rowHeads[row];
+    }
+    
+    // Get the first node of a column (follow down for the rest)
+    const Node* getColumn(Index col) const {
+        if (isNegativeIndex(col) || col >= cols) {
+            throw std::out_of_range("Column index out of bounds");
+        }
+        return colHeads[col];
+    }
+    
+    // Add two sparse matrices
+    BasicSparseMatrix add(const BasicSparseMatrix& other) const {
+        return axpby(Value(1), Value(1), other);
+    }
+    
+    // Compute alpha * this + beta * other by merging the sorted row lists of
+    // both operands in one pass and appending to the tails of the result
+    BasicSparseMatrix axpby(Value alpha, Value beta, const BasicSparseMatrix& other) const {
+        if (rows != other.rows || cols != other.cols) {
+            throw std::invalid_argument("Matrix dimensions must match for addition");
+        }
+        
+        BasicSparseMatrix result(rows, cols);
+        std::vector<Node*> rowTails(rows, nullptr);
+        std::vector<Node*> colTails(cols, nullptr);
+        
+        for (Index r = 0; r < rows; r++) {
+            Node* a = rowHeads[r];
+            Node* b = other.rowHeads[r];
+            while (a != nullptr || b != nullptr) {
+                Index col;
+                Value value;
+                if (b == nullptr || (a != nullptr && a->col < b->col)) {
+                    col = a->col;
+                    value = alpha * a->value;
+                    a = a->next;
+                } else if (a == nullptr || a->col != b->col) {
+                    col = b->col;
+                    value = beta * b->value;
+                    b = b->next;
+                } else {
+                    col = a->col;
+                    value = alpha * a->value + beta * b->value;
+                    a = a->next;
+                    b = b->next;
+                }
+                
+                if (value != Value(0)) {
+                    result.appendInOrder(r, col, value, rowTails, colTails);
+                }
+            }
+        }
+        
+        return result;
+    }
+    
+    // Multiply two sparse matrices. Each output row is accumulated in a sparse
+    // accumulator (dense values + touched-column list) from the rows of B picked
+    // out by row i of A, then emitted in column order. Rows are split into
+    // contiguous ranges of about equal multiply-add count, handed out by
+    // parallelForBlocks; numThreads = 0 uses every hardware thread.
+    BasicSparseMatrix multiply(const BasicSparseMatrix& other, int numThreads = 0) const {
+        if (cols != other.rows) {
+            throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
+        }
+        
+        if (numThreads <= 0) {
+            numThreads = defaultThreadCount();
+        }
+        
+        // Work per row of A (multiply-adds, plus one so empty rows still count),
+        // prefix-summed so skewed rows do not pile onto one range
+        std::vector<long long> otherRowLength(other.rows, 0);
+        for (Index r = 0; r < other.rows; r++) {
+            for (Node* b = other.rowHeads[r]; b != nullptr; b = b->next) {
+                otherRowLength[r]++;
+            }
+        }
+        std::vector<long long> work(rows + 1, 0);
+        for (Index i = 0; i < rows; i++) {
+            work[i + 1] = work[i] + 1;
+            for (Node* a = rowHeads[i]; a != nullptr; a = a->next) {
+                work[i + 1] += otherRowLength[a->col];
+            }
+        }
+        numThreads = (int)std::max<long long>(1, std::min<long long>(numThreads, work[rows] / 10000));
+        
+        // A few ranges per thread so one heavy range does not stall the rest
+        int numRanges = numThreads == 1 ? 1 : numThreads * 4;
+        std::vector<Index> bounds(numRanges + 1, rows);
+        bounds[0] = 0;
+        for (int p = 1; p < numRanges; p++) {
+            long long target = work[rows] * p / numRanges;
+            Index row = (Index)(std::lower_bound(work.begin(), work.end(), target) - work.begin());
+            bounds[p] = std::min(std::max(row, bounds[p - 1]), rows);
+        }
+        
+        // Output of one range of rows: (col, value) entries plus per-row end offsets
+        struct RangeResult {
+            std::vector<std::pair<Index, Value>> entries;
+            std::vector<size_t> rowEnds;
+        };
+        std::vector<RangeResult> ranges(numRanges);
+        
+        // Sparse accumulator of one worker thread
+        struct Accumulator {
+            std::vector<Value> values;
+            std::vector<char> occupied;
+            std::vector<Index> touched;
+        };
+        std::vector<Accumulator> accumulators(numThreads);
+        
+        parallelForBlocks(numRanges, 1, numThreads, [&](size_t begin, size_t end, int t) {
+            Accumulator& acc = accumulators[t];
+            if (acc.values.size() != (size_t)other.cols) {
+                acc.values.assign(other.cols, Value(0));
+                acc.occupied.assign(other.cols, 0);
+            }
+            
+            for (size_t part = begin; part < end; part++) {
+                RangeResult& out = ranges[part];
+                for (Index i = bounds[part]; i < bounds[part + 1]; i++) {
+                    acc.touched.clear();
+                    for (Node* a = rowHeads[i]; a != nullptr; a = a->next) {
+                        for (Node* b = other.rowHeads[a->col]; b != nullptr; b = b->next) {
+                            if (!acc.occupied[b->col]) {
+                                acc.occupied[b->col] = 1;
+                                acc.touched.push_back(b->col);
+                            }
+                            acc.values[b->col] += a->value * b->value;
+                        }
+                    }
+                    
+                    std::sort(acc.touched.begin(), acc.touched.end());
+                    for (Index j : acc.touched) {
+                        if (acc.values[j] != Value(0)) {
+                            out.entries.push_back({j, acc.values[j]});
+                        }
+                        acc.values[j] = Value(0);
+                        acc.occupied[j] = 0;
+                    }
+                    out.rowEnds.push_back(out.entries.size());
+                }
+            }
+        });
+        
+        // Emit nodes in (row, col) order; the pool is not shared between threads
+        BasicSparseMatrix result(rows, other.cols);
+        std::vector<Node*> rowTails(rows, nullptr);
+        std::vector<Node*> colTails(other.cols, nullptr);
+        Index row = 0;
+        for (const RangeResult& range : ranges) {
+            size_t start = 0;
+            for (size_t end : range.rowEnds) {
+                for (size_t k = start; k < end; k++) {
+                    result.appendInOrder(row, range.entries[k].first, range.entries[k].second, 
+                                         rowTails, colTails);
+                }
+                start = end;
+                row++;
+            }
+        }
+        
+        return result;
+    }
+    
+    // Transpose the matrix: column c read top to bottom is row c of the result
+    BasicSparseMatrix transpose() const {
+        BasicSparseMatrix result(cols, rows);
+        std::vector<Node*> rowTails(cols, nullptr);
+        std::vector<Node*> colTails(rows, nullptr);
+        
+        for (Index c = 0; c < cols; c++) {
+            for (Node* current = colHeads[c]; current != nullptr; current = current->down) {
+                result.appendInOrder(c, current->row, current->value, rowTails, colTails);
+            }
+        }
+        
+        return result;
+    }
+    
+    // Display the matrix
+    void display() const {
+        std::cout << "Sparse Matrix (" << rows << "x" << cols << "):" << std::endl;
+        for (Index i = 0; i < rows; i++) {
+            Node* current = rowHeads[i];
+            for (Index j = 0; j < cols; j++) {
+                Value value = Value(0);
+                if (current != nullptr && current->col == j) {
+                    value = current->value;
+                    current = current->next;
+                }
+                std::cout << value << "\t";
+            }
+            std::cout << std::endl;
+        }
+        std::cout << std::endl;
+    }
+    
+    // Call f(row, col, value) for every non-zero in (row, col) order
+    template <typename F>
+    void forEachNonZero(F f) const {
+        for (Index i = 0; i < rows; i++) {
+            for (Node* current = rowHeads[i]; current != nullptr; current = current->next) {
+                f(current->row, current->col, current->value);
+            }
+        }
+    }
+    
+    // Call f(col, value) for the non-zeros of one row in column order
+    template <typename F>
+    void forEachInRow(Index row, F f) const {
+        for (Node* current = rowHeads[row]; current != nullptr; current = current->next) {
+            f(current->col, current->value);
+        }
+    }
+    
+    // Call f(row, value) for the non-zeros of one column in row order
+    template <typename F>
+    void forEachInColumn(Index col, F f) const {
+        for (Node* current = colHeads[col]; current != nullptr; current = current->down) {
+            f(current->row, current->value);
+        }
+    }
+    
+    // Display only non-zero elements
+    void displaySparse() const {
+        std::cout << "Non-zero elements:" << std::endl;
+        for (Index i = 0; i < rows; i++) {
+            for (Node* current = rowHeads[i]; current != nullptr; current = current->next) {
+                std::cout << "(" << current->row << ", " << current->col << ") = " 
+                     << current->value << std::endl;
+            }
+        }
+        std::cout << std::endl;
+    }
+    
+    // Get number of non-zero elements
+    Index getNonZeroCount() const {
+        return count;
+    }
+    
+    // Check if matrix is empty (all zeros)
+    bool isEmpty() const {
+        return count == 0;
+    }
+    
+    // Clear all elements (bulk release of the node pool)
+    void clear() {
+        std::fill(rowHeads.begin(), rowHeads.end(), nullptr);
+        std::fill(colHeads.begin(), colHeads.end(), nullptr);
+        count = 0;
+        pool.release();
+    }
+    
+    // Get matrix dimensions
+    std::pair<Index, Index> getDimensions() const {
+        return std::make_pair(rows, cols);
+    }
+    
+    // Get memory usage in bytes (node slabs, row/column heads and the matrix object)
+    size_t getMemoryUsage() const {
+        return sizeof(*this) + pool.getMemoryUsage() + 
+               sizeof(Node*) * (rowHeads.capacity() + colHeads.capacity());
+    }
+};
+
+// The original double-valued, int-indexed linked-list matrix
+using SparseMatrix = BasicSparseMatrix<double, int>;
+
+#endif // LINKED_LIST_H
@@ -0,0 +1,740 @@
+#ifndef SPARSE_MATRIX_H
+#define SPARSE_MATRIX_H
+
+// Common interface of the sparse matrix backends (linkedList.h, arrayImplementation.h).
+//
+// Every backend exposes value_type, index_type, getDimensions(), getNonZeroCount()
+// and forEachNonZero(f), which calls f(row, col, value) in (row, col) order. The
+// generic algorithms and lazy expressions at the end of this file work on any
+// such type, and the parallel and SIMD kernels here are shared by all of them.
+// Value types are float, double and int; index types are uint32_t and uint64_t,
+// plus int for the original double/int backends.
+
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <cstdint>
+#include <cmath>
+#include <thread>
+#include <atomic>
+#include <memory>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// Value types a sparse matrix may store
+template <typename T>
+struct isSparseValue : std::integral_constant<bool, std::is_same<T, float>::value ||
+                                                    std::is_same<T, double>::value ||
+                                                    std::is_same<T, int>::value> {};
+
+// Index types a sparse matrix may use for rows, columns and row pointers
+template <typename T>
+struct isSparseIndex : std::integral_constant<bool, std::is_same<T, int>::value ||
+                                                    std::is_same<T, uint32_t>::value ||
+                                                    std::is_same<T, uint64_t>::value> {};
+
+// Bounds check helper: only signed index types can be negative
+template <typename Index>
+bool isNegativeIndex(Index i) {
+    if constexpr (std::is_signed<Index>::value) {
+        return i < 0;
+    } else {
+        (void)i;
+        return false;
+    }
+}
+
+// Number of worker threads to use when the caller passes 0
+inline int defaultThreadCount() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n > 0 ? (int)n : 1;
+}
+
+// Run body(begin, end, threadId) over [0, count) in blocks of blockSize pulled
+// from a shared counter, so uneven rows are balanced across numThreads workers
+template <typename Body>
+void parallelForBlocks(size_t count, size_t blockSize, int numThreads, Body body) {
+    if (numThreads <= 0) {
+        numThreads = defaultThreadCount();
+    }
+    size_t numBlocks = (count + blockSize - 1) / blockSize;
+    numThreads = (int)std::max<size_t>(1, std::min<size_t>(numThreads, numBlocks));
+    
+    std::atomic<size_t> nextBlock(0);
+    auto worker = [&](int threadId) {
+        size_t block;
+        while ((block = nextBlock.fetch_add(1)) < numBlocks) {
+            size_t begin = block * blockSize;
+            body(begin, std::min(begin + blockSize, count), threadId);
+        }
+    };
+    
+    std::vector<std::thread> threads;
+    for (int t = 1; t < numThreads; t++) {
+        threads.emplace_back(worker, t);
+    }
+    worker(0);
+    for (std::thread& t : threads) {
+        t.join();
+    }
+}
+
+#ifdef __AVX2__
+// Gather x[idx[0..3]]; the masked form avoids reading an undefined source register
+inline __m256d gatherDoubles(const double* x, __m128i idx) {
+    __m256d allLanes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), x, idx, allLanes, 8);
+}
+
+// Gather four doubles at the next four column indices of each index type.
+// Unsigned 32-bit indices are zero-extended so columns past 2^31 stay valid.
+inline __m256d gatherDoubles(const double* x, const int* cols) {
+    return gatherDoubles(x, _mm_loadu_si128((const __m128i*)cols));
+}
+
+inline __m256d gatherDoubles(const double* x, const uint32_t* cols) {
+    __m256i idx = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)cols));
+    __m256d allLanes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    return _mm256_mask_i64gather_pd(_mm256_setzero_pd(), x, idx, allLanes, 8);
+}
+
+inline __m256d gatherDoubles(const double* x, const uint64_t* cols) {
+    __m256i idx = _mm256_loadu_si256((const __m256i*)cols);
+    __m256d allLanes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    return _mm256_mask_i64gather_pd(_mm256_setzero_pd(), x, idx, allLanes, 8);
+}
+
+// Gather eight floats at the next eight column indices of each index type
+inline __m256 gatherFloats(const float* x, const int* cols) {
+    __m256i idx = _mm256_loadu_si256((const __m256i*)cols);
+    __m256 allLanes = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    return _mm256_mask_i32gather_ps(_mm256_setzero_ps(), x, idx, allLanes, 4);
+}
+
+inline __m128 gatherFloats(const float* x, __m256i idx64) {
+    __m128 allLanes = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    return _mm256_mask_i64gather_ps(_mm_setzero_ps(), x, idx64, allLanes, 4);
+}
+
+inline __m256 gatherFloats(const float* x, const uint32_t* cols) {
+    __m128i low = _mm_loadu_si128((const __m128i*)cols);
+    __m128i high = _mm_loadu_si128((const __m128i*)(cols + 4));
+    return _mm256_set_m128(gatherFloats(x, _mm256_cvtepu32_epi64(high)),
+                           gatherFloats(x, _mm256_cvtepu32_epi64(low)));
+}
+
+inline __m256 gatherFloats(const float* x, const uint64_t* cols) {
+    return _mm256_set_m128(gatherFloats(x, _mm256_loadu_si256((const __m256i*)(cols + 4))),
+                           gatherFloats(x, _mm256_loadu_si256((const __m256i*)cols)));
+}
+
+// acc + a * b, fused when FMA is available
+inline __m256d multiplyAdd(__m256d a, __m256d b, __m256d acc) {
+#ifdef __FMA__
+    return _mm256_fmadd_pd(a, b, acc);
+#else
+    return _mm256_add_pd(acc, _mm256_mul_pd(a, b));
+#endif
+}
+
+inline __m256 multiplyAdd(__m256 a, __m256 b, __m256 acc) {
+#ifdef __FMA__
+    return _mm256_fmadd_ps(a, b, acc);
+#else
+    return _mm256_add_ps(acc, _mm256_mul_ps(a, b));
+#endif
+}
+
+inline __m128d multiplyAdd(__m128d a, __m128d b, __m128d acc) {
+#ifdef __FMA__
+    return _mm_fmadd_pd(a, b, acc);
+#else
+    return _mm_add_pd(acc, _mm_mul_pd(a, b));
+#endif
+}
+
+inline __m128 multiplyAdd(__m128 a, __m128 b, __m128 acc) {
+#ifdef __FMA__
+    return _mm_fmadd_ps(a, b, acc);
+#else
+    return _mm_add_ps(acc, _mm_mul_ps(a, b));
+#endif
+}
+
+// Sum of all lanes
+inline double horizontalSum(__m256d v) {
+    __m128d half = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+}
+
+inline float horizontalSum(__m256 v) {
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+    return _mm_cvtss_f32(_mm_add_ss(half, _mm_movehdup_ps(half)));
+}
+#endif
+
+// Dot product of one sparse row with a dense vector: sum of vals[k] * x[cols[k]].
+// With AVX2, double rows gather four columns per step and float rows eight, so
+// float halves the value traffic and doubles the lanes; int values run scalar.
+template <typename Value, typename Index>
+Value sparseRowDot(const Index* cols, const Value* vals, size_t count, const Value* x) {
+    size_t k = 0;
+    Value sum = 0;
+#ifdef __AVX2__
+    if constexpr (std::is_same<Value, double>::value) {
+        __m256d acc = _mm256_setzero_pd();
+        for (; k + 4 <= count; k += 4) {
+            acc = multiplyAdd(_mm256_loadu_pd(vals + k), gatherDoubles(x, cols + k), acc);
+        }
+        sum = horizontalSum(acc);
+    } else if constexpr (std::is_same<Value, float>::value) {
+        __m256 acc = _mm256_setzero_ps();
+        for (; k + 8 <= count; k += 8) {
+            acc = multiplyAdd(_mm256_loadu_ps(vals + k), gatherFloats(x, cols + k), acc);
+        }
+        sum = horizontalSum(acc);
+    }
+#endif
+    for (; k < count; k++) {
+        sum += vals[k] * x[cols[k]];
+    }
+    return sum;
+}
+
+#ifdef __AVX2__
+// Prefetch the TILES * 32 bytes of a dense row that one register tile reads
+template <int TILES>
+inline void prefetchTile(const void* row) {
+    const char* bytes = static_cast<const char*>(row);
+    for (int line = 0; line < TILES * 32; line += 64) {
+        _mm_prefetch(bytes + line, _MM_HINT_T0);
+    }
+}
+
+// Register tile of sparseRowTimesDense: TILES AVX2 vectors of the output row
+// stay in accumulators while the whole sparse row is applied to them
+template <int TILES, typename Value, typename Index>
+inline void sparseRowDenseTile(const Index* cols, const Value* vals, size_t count,
+                               const Value* b, size_t ldb, Value* out) {
+    const size_t PREFETCH_DISTANCE = 4;
+    if constexpr (std::is_same<Value, double>::value) {
+        __m256d acc[TILES];
+        for (int t = 0; t < TILES; t++) {
+            acc[t] = _mm256_setzero_pd();
+        }
+        for (size_t j = 0; j < count; j++) {
+            if (j + PREFETCH_DISTANCE < count) {
+                prefetchTile<TILES>(b + (size_t)cols[j + PREFETCH_DISTANCE] * ldb);
+            }
+            __m256d a = _mm256_set1_pd(vals[j]);
+            const double* row = b + (size_t)cols[j] * ldb;
+            for (int t = 0; t < TILES; t++) {
+                acc[t] = multiplyAdd(a, _mm256_loadu_pd(row + 4 * t), acc[t]);
+            }
+        }
+        for (int t = 0; t < TILES; t++) {
+            _mm256_storeu_pd(out + 4 * t, acc[t]);
+        }
+    } else {
+        __m256 acc[TILES];
+        for (int t = 0; t < TILES; t++) {
+            acc[t] = _mm256_setzero_ps();
+        }
+        for (size_t j = 0; j < count; j++) {
+            if (j + PREFETCH_DISTANCE < count) {
+                prefetchTile<TILES>(b + (size_t)cols[j + PREFETCH_DISTANCE] * ldb);
+            }
+            __m256 a = _mm256_set1_ps(vals[j]);
+            const float* row = b + (size_t)cols[j] * ldb;
+            for (int t = 0; t < TILES; t++) {
+                acc[t] = multiplyAdd(a, _mm256_loadu_ps(row + 8 * t), acc[t]);
+            }
+        }
+        for (int t = 0; t < TILES; t++) {
+            _mm256_storeu_ps(out + 8 * t, acc[t]);
+        }
+    }
+}
+#endif
+
+// One row of a sparse x dense product: out[0, k) = sum of vals[j] * b[cols[j]][0, k)
+// with b row-major (row stride ldb). With AVX2 the k columns are cut into register
+// tiles of 8 vectors (32 doubles or 64 floats), then single vectors, so each
+// output element is written once and the FMAs never wait on memory; the rest of
+// the columns (and int values) run scalar.
+template <typename Value, typename Index>
+void sparseRowTimesDense(const Index* cols, const Value* vals, size_t count,
+                         const Value* b, size_t ldb, size_t k, Value* out) {
+    size_t c = 0;
+#ifdef __AVX2__
+    if constexpr (std::is_same<Value, double>::value || std::is_same<Value, float>::value) {
+        constexpr size_t LANES = 32 / sizeof(Value);
+        for (; c + 8 * LANES <= k; c += 8 * LANES) {
+            sparseRowDenseTile<8>(cols, vals, count, b + c, ldb, out + c);
+        }
+        for (; c + LANES <= k; c += LANES) {
+            sparseRowDenseTile<1>(cols, vals, count, b + c, ldb, out + c);
+        }
+    }
+#endif
+    if (c < k) {
+        std::fill(out + c, out + k, Value(0));
+        for (size_t j = 0; j < count; j++) {
+            const Value* row = b + (size_t)cols[j] * ldb;
+            for (size_t cc = c; cc < k; cc++) {
+                out[cc] += vals[j] * row[cc];
+            }
+        }
+    }
+}
+
+// Two-pass counting-sort transpose into CSR arrays (column histogram, prefix sum,
+// scatter). forEachInChunk(chunk, emit) must call emit(row, col, value) for the
+// entries of each chunk in (row, col) order, the chunks together covering all
+// entries in order; chunks are counted and scattered in parallel with private
+// histograms so the output rows stay sorted.
+template <typename Value, typename Index, typename ForEachInChunk>
+void countingSortTranspose(Index cols, size_t nnz, int numChunks, int numThreads,
+                           ForEachInChunk forEachInChunk, std::vector<Index>& outPtr,
+                           std::vector<Index>& outIdx, std::vector<Value>& outValues) {
+    std::vector<std::vector<Index>> histograms(numChunks, std::vector<Index>(cols, 0));
+    
+    // Pass 1: per-chunk column histograms
+    parallelForBlocks(numChunks, 1, numThreads, [&](size_t begin, size_t end, int) {
+        for (size_t chunk = begin; chunk < end; chunk++) {
+            std::vector<Index>& histogram = histograms[chunk];
+            forEachInChunk(chunk, [&](Index, Index col, Value) { histogram[col]++; });
+        }
+    });
+    
+    // Prefix sum over (column, chunk) turns counts into scatter offsets
+    outPtr.assign((size_t)cols + 1, 0);
+    Index offset = 0;
+    for (Index c = 0; c < cols; c++) {
+        outPtr[c] = offset;
+        for (int chunk = 0; chunk < numChunks; chunk++) {
+            Index count = histograms[chunk][c];
+            histograms[chunk][c] = offset;
+            offset += count;
+        }
+    }
+    outPtr[cols] = offset;
+    
+    // Pass 2: scatter each entry to its slot in the transposed row
+    outIdx.resize(nnz);
+    outValues.resize(nnz);
+    parallelForBlocks(numChunks, 1, numThreads, [&](size_t begin, size_t end, int) {
+        for (size_t chunk = begin; chunk < end; chunk++) {
+            std::vector<Index>& next = histograms[chunk];
+            forEachInChunk(chunk, [&](Index row, Index col, Value value) {
+                Index slot = next[col]++;
+                outIdx[slot] = row;
+                outValues[slot] = value;
+            });
+        }
+    });
+}
+
+// Generic algorithms over any backend
+
+// Detects a native raw-array kernel multiply(const value_type* x, value_type* y)
+template <typename Matrix, typename = void>
+struct hasNativeSpMV : std::false_type {};
+
+template <typename Matrix>
+struct hasNativeSpMV<Matrix, std::void_t<decltype(std::declval<const Matrix&>().multiply(
+    std::declval<const typename Matrix::value_type*>(), std::declval<typename Matrix::value_type*>()))>>
+    : std::true_type {};
+
+// y = A * x for any backend: the backend's own kernel when it has one,
+// otherwise one pass over its non-zeros
+template <typename Matrix>
+void sparseMultiply(const Matrix& a, const typename Matrix::value_type* x,
+                    typename Matrix::value_type* y) {
+    if constexpr (hasNativeSpMV<Matrix>::value) {
+        a.multiply(x, y);
+    } else {
+        std::fill(y, y + a.getDimensions().first, typename Matrix::value_type(0));
+        a.forEachNonZero([&](auto row, auto col, auto value) { y[row] += value * x[col]; });
+    }
+}
+
+// Convert any backend to a CSR type (e.g. BasicCSRMatrix<float, uint32_t>),
+// casting values and indices; throws if the dimensions do not fit the index type
+template <typename CSR, typename Matrix>
+CSR convertToCSR(const Matrix& a) {
+    using Value = typename CSR::value_type;
+    using Index = typename CSR::index_type;
+    
+    auto dims = a.getDimensions();
+    unsigned long long nnz = (unsigned long long)a.getNonZeroCount();
+    unsigned long long limit = (unsigned long long)std::numeric_limits<Index>::max();
+    if ((unsigned long long)dims.first >= limit || (unsigned long long)dims.second >= limit ||
+        nnz > limit) {
+        throw std::out_of_range("Matrix too large for the index type");
+    }
+    
+    Index rows = (Index)dims.first;
+    std::vector<Index> rowPtr((size_t)rows + 1, 0);
+    std::vector<Index> colIdx;
+    std::vector<Value> values;
+    colIdx.reserve(nnz);
+    values.reserve(nnz);
+    a.forEachNonZero([&](auto row, auto col, auto value) {
+        rowPtr[(size_t)row + 1]++;
+        colIdx.push_back((Index)col);
+        values.push_back((Value)value);
+    });
+    for (Index i = 0; i < rows; i++) {
+        rowPtr[i + 1] += rowPtr[i];
+    }
+    
+    return CSR(rows, (Index)dims.second, std::move(rowPtr), std::move(colIdx), std::move(values));
+}
+
+// True if two matrices (of any backends) have the same dimensions and the same
+// non-zeros, values agreeing within tolerance
+template <typename MatrixA, typename MatrixB>
+bool sparseEqual(const MatrixA& a, const MatrixB& b, double tolerance = 0.0) {
+    auto dimsA = a.getDimensions();
+    auto dimsB = b.getDimensions();
+    if ((unsigned long long)dimsA.first != (unsigned long long)dimsB.first ||
+        (unsigned long long)dimsA.second != (unsigned long long)dimsB.second ||
+        (unsigned long long)a.getNonZeroCount() != (unsigned long long)b.getNonZeroCount()) {
+        return false;
+    }
+    
+    struct Entry {
+        unsigned long long row;
+        unsigned long long col;
+        double value;
+    };
+    std::vector<Entry> entries;
+    entries.reserve(a.getNonZeroCount());
+    a.forEachNonZero([&](auto row, auto col, auto value) {
+        entries.push_back({(unsigned long long)row, (unsigned long long)col, (double)value});
+    });
+    
+    size_t k = 0;
+    bool equal = true;
+    b.forEachNonZero([&](auto row, auto col, auto value) {
+        if (!equal) return;
+        const Entry& e = entries[k++];
+        if (e.row != (unsigned long long)row || e.col != (unsigned long long)col ||
+            std::fabs(e.value - (double)value) > tolerance) {
+            equal = false;
+        }
+    });
+    return equal;
+}
+
+// Frobenius norm: square root of the sum of squared non-zeros
+template <typename Matrix>
+double frobeniusNorm(const Matrix& a) {
+    double sum = 0.0;
+    a.forEachNonZero([&](auto, auto, auto value) { sum += (double)value * (double)value; });
+    return std::sqrt(sum);
+}
+
+// Lazy expressions
+//
+// A + B, alpha * A, A - B and transpose(A) on backends with row access build an
+// expression instead of a matrix. Scalings and transposes are pushed down to
+// the operands as they are applied, so every expression is a sum of scaled,
+// possibly transposed terms, and the destination evaluates it in one pass:
+//     SparseMatrixArray d = 2.0 * a + transpose(b) - c;
+//     c = 2.0 * a + transpose(b) - c;  // assigning may read the destination
+// Expressions refer to their operands, which must outlive the evaluation.
+
+// Detects m.forEachInRow(row, f), calling f(col, value) in column order
+template <typename Matrix, typename = void>
+struct hasRowAccess : std::false_type {};
+
+template <typename Matrix>
+struct hasRowAccess<Matrix, std::void_t<decltype(std::declval<const Matrix&>().forEachInRow(
+    typename Matrix::index_type(0),
+    std::declval<void (*)(typename Matrix::index_type, typename Matrix::value_type)>()))>>
+    : std::true_type {};
+
+// Detects m.forEachInColumn(col, f), calling f(row, value) in row order
+template <typename Matrix, typename = void>
+struct hasColumnAccess : std::false_type {};
+
+template <typename Matrix>
+struct hasColumnAccess<Matrix, std::void_t<decltype(std::declval<const Matrix&>().forEachInColumn(
+    typename Matrix::index_type(0),
+    std::declval<void (*)(typename Matrix::index_type, typename Matrix::value_type)>()))>>
+    : std::true_type {};
+
+// Detects m.forEachInRow(row, position, f): rows read in increasing order with
+// one position variable are walked in a single pass (COO arrays, which would
+// otherwise search for every row)
+template <typename Matrix, typename = void>
+struct hasSequentialRowAccess : std::false_type {};
+
+template <typename Matrix>
+struct hasSequentialRowAccess<Matrix, std::void_t<decltype(std::declval<const Matrix&>().forEachInRow(
+    typename Matrix::index_type(0), std::declval<size_t&>(),
+    std::declval<void (*)(typename Matrix::index_type, typename Matrix::value_type)>()))>>
+    : std::true_type {};
+
+// Rows of transpose(A) as CSR arrays, for backends without column access
+template <typename Value, typename Index>
+struct TransposedRows {
+    std::vector<Index> rowPtr;
+    std::vector<Index> colIdx;
+    std::vector<Value> values;
+};
+
+// One operand of an expression: scale * matrix or scale * transpose(matrix).
+// Transposed rows are read straight from the columns of backends with column
+// access; for other backends transpose() counting-sorts the non-zeros once into
+// CSR arrays that the evaluation reads directly, without building a matrix.
+template <typename Matrix>
+class SparseTerm {
+private:
+    using Value = typename Matrix::value_type;
+    using Index = typename Matrix::index_type;
+    
+    const Matrix* source;
+    std::shared_ptr<const TransposedRows<Value, Index>> transposedRows;
+    double scale;
+    bool transposed;
+    mutable size_t position;  // Row cursor of sequential backends, reset by startRows()
+    
+public:
+    static constexpr int TERMS = 1;
+    
+    explicit SparseTerm(const Matrix& m) : source(&m), scale(1.0), transposed(false), position(0) {}
+    
+    SparseTerm scaled(double alpha) const {
+        SparseTerm result = *this;
+        result.scale *= alpha;
+        return result;
+    }
+    
+    SparseTerm transposedTerm() const {
+        SparseTerm result = *this;
+        result.transposed = !transposed;
+        if constexpr (!hasColumnAccess<Matrix>::value) {
+            if (result.transposed && !result.transposedRows) {
+                auto rows = std::make_shared<TransposedRows<Value, Index>>();
+                countingSortTranspose<Value, Index>(
+                    (Index)source->getDimensions().second, (size_t)source->getNonZeroCount(), 1, 1,
+                    [&](size_t, auto emit) { source->forEachNonZero(emit); },
+                    rows->rowPtr, rows->colIdx, rows->values);
+                result.transposedRows = rows;
+            }
+        }
+        return result;
+    }
+    
+    std::pair<size_t, size_t> getDimensions() const {
+        auto dims = source->getDimensions();
+        return transposed ? std::make_pair((size_t)dims.second, (size_t)dims.first)
+                          : std::make_pair((size_t)dims.first, (size_t)dims.second);
+    }
+    
+    size_t getNonZeroBound() const {
+        return (size_t)source->getNonZeroCount();
+    }
+    
+    template <typename F>
+    void forEachTerm(F f) const {
+        f(*this);
+    }
+    
+    // Start reading rows from the top; rows must then be read in increasing order
+    void startRows() const {
+        position = 0;
+    }
+    
+    // Call f(col, value) for the scaled non-zeros of one row, in column order
+    template <typename F>
+    void forEachInRow(size_t row, F f) const {
+        auto emit = [&](Index col, Value value) {
+            f((size_t)col, scale * (double)value);
+        };
+        if (!transposed) {
+            if constexpr (hasSequentialRowAccess<Matrix>::value) {
+                source->forEachInRow((Index)row, position, emit);
+            } else {
+                source->forEachInRow((Index)row, emit);
+            }
+        } else if constexpr (hasColumnAccess<Matrix>::value) {
+            source->forEachInColumn((Index)row, emit);
+        } else {
+            const TransposedRows<Value, Index>& t = *transposedRows;
+            for (Index k = t.rowPtr[row]; k < t.rowPtr[row + 1]; k++) {
+                emit(t.colIdx[k], t.values[k]);
+            }
+        }
+    }
+};
+
+// Sum of two expressions
+template <typename Left, typename Right>
+class SparseSum {
+private:
+    Left left;
+    Right right;
+    
+public:
+    static constexpr int TERMS = Left::TERMS + Right::TERMS;
+    
+    SparseSum(Left l, Right r) : left(std::move(l)), right(std::move(r)) {
+        if (left.getDimensions() != right.getDimensions()) {
+            throw std::invalid_argument("Matrix dimensions must match for addition");
+        }
+    }
+    
+    SparseSum scaled(double alpha) const {
+        return SparseSum(left.scaled(alpha), right.scaled(alpha));
+    }
+    
+    SparseSum transposedTerm() const {
+        return SparseSum(left.transposedTerm(), right.transposedTerm());
+    }
+    
+    std::pair<size_t, size_t> getDimensions() const {
+        return left.getDimensions();
+    }
+    
+    size_t getNonZeroBound() const {
+        return left.getNonZeroBound() + right.getNonZeroBound();
+    }
+    
+    template <typename F>
+    void forEachTerm(F f) const {
+        left.forEachTerm(f);
+        right.forEachTerm(f);
+    }
+};
+
+template <typename T>
+struct isSparseExpression : std::false_type {};
+
+template <typename Matrix>
+struct isSparseExpression<SparseTerm<Matrix>> : std::true_type {};
+
+template <typename Left, typename Right>
+struct isSparseExpression<SparseSum<Left, Right>> : std::true_type {};
+
+// Backends with row access and expressions can appear in an expression
+template <typename T>
+struct isSparseOperand
+    : std::integral_constant<bool, isSparseExpression<T>::value || hasRowAccess<T>::value> {};
+
+template <typename T>
+auto toSparseExpression(const T& operand) {
+    if constexpr (isSparseExpression<T>::value) {
+        return operand;
+    } else {
+        return SparseTerm<T>(operand);
+    }
+}
+
+template <typename A, typename B,
+          typename = std::enable_if_t<isSparseOperand<A>::value && isSparseOperand<B>::value>>
+auto operator+(const A& a, const B& b) {
+    auto left = toSparseExpression(a);
+    auto right = toSparseExpression(b);
+    return SparseSum<decltype(left), decltype(right)>(left, right);
+}
+
+template <typename A, typename = std::enable_if_t<isSparseOperand<A>::value>>
+auto operator*(double alpha, const A& a) {
+    return toSparseExpression(a).scaled(alpha);
+}
+
+template <typename A, typename = std::enable_if_t<isSparseOperand<A>::value>>
+auto operator*(const A& a, double alpha) {
+    return toSparseExpression(a).scaled(alpha);
+}
+
+template <typename A, typename = std::enable_if_t<isSparseOperand<A>::value>>
+auto operator-(const A& a) {
+    return toSparseExpression(a).scaled(-1.0);
+}
+
+template <typename A, typename B,
+          typename = std::enable_if_t<isSparseOperand<A>::value && isSparseOperand<B>::value>>
+auto operator-(const A& a, const B& b) {
+    return a + (-b);
+}
+
+template <typename A, typename = std::enable_if_t<isSparseOperand<A>::value>>
+auto transpose(const A& a) {
+    return toSparseExpression(a).transposedTerm();
+}
+
+// Evaluate an expression row by row, calling emit(row, col, value) for every
+// non-zero of the result in (row, col) order. Each term's row is already sorted,
+// so the rows of all terms are gathered into small buffers (sized up front from
+// the average row length) and merged; entries that cancel to zero are dropped.
+template <typename Expr, typename Emit>
+void evaluateSparseExpression(const Expr& expr, Emit emit) {
+    constexpr int TERMS = Expr::TERMS;
+    const size_t END = std::numeric_limits<size_t>::max();
+    auto dims = expr.getDimensions();
+    std::vector<std::pair<size_t, double>> termRows[TERMS];
+    
+    int reserved = 0;
+    expr.forEachTerm([&](const auto& term) {
+        term.startRows();
+        if (TERMS > 1) {
+            termRows[reserved++].reserve(std::min(dims.second, 2 * term.getNonZeroBound() / std::max<size_t>(dims.first, 1)) + 16);
+        }
+    });
+    
+    for (size_t i = 0; i < dims.first; i++) {
+        if constexpr (TERMS == 1) {
+            expr.forEachTerm([&](const auto& term) {
+                term.forEachInRow(i, [&](size_t col, double value) {
+                    if (value != 0.0) {
+                        emit(i, col, value);
+                    }
+                });
+            });
+            continue;
+        }
+        
+        // Each buffer ends in an END sentinel, so the merge needs no bounds checks
+        const std::pair<size_t, double>* head[TERMS];
+        int t = 0;
+        expr.forEachTerm([&](const auto& term) {
+            std::vector<std::pair<size_t, double>>& buffer = termRows[t];
+            buffer.clear();
+            term.forEachInRow(i, [&](size_t col, double value) { buffer.push_back({col, value}); });
+            buffer.push_back({END, 0.0});
+            head[t++] = buffer.data();
+        });
+        
+        while (true) {
+            size_t col = head[0]->first;
+            for (int u = 1; u < TERMS; u++) {
+                col = std::min(col, head[u]->first);
+            }
+            if (col == END) {
+                break;
+            }
+            
+            double sum = 0.0;
+            for (int u = 0; u < TERMS; u++) {
+                if (head[u]->first == col) {
+                    sum += head[u]->second;
+                    head[u]++;
+                }
+            }
+            if (sum != 0.0) {
+                emit(i, col, sum);
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,432 @@
+#ifndef SPARSE_SOLVERS_H
+#define SPARSE_SOLVERS_H
+
+// Preconditioned Krylov solvers for A x = b on CSR matrices: conjugate gradient
+// for symmetric positive definite A and BiCGSTAB for general square A, with
+// Jacobi and ILU(0) preconditioners. A SparseMatrixArray is converted once with
+// toCSR() so every iteration runs the threaded SIMD SpMV kernel.
+//
+// Each vector update is fused with the dot product that consumes it, and each
+// SpMV with the dot of its result, so an iteration streams every vector as few
+// times as possible. Reductions add per-thread partial sums in a fixed order,
+// which makes a solve reproducible for a given thread count.
+
+#include <vector>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include "arrayImplementation.h"
+
+// Outcome of an iterative solve
+struct SolverResult {
+    bool converged;
+    int iterations;
+    double residual;  // True relative residual ||b - A x|| / ||b|| of the returned x
+};
+
+// Threads worth using for vectors of length n; below ~32K rows per thread the
+// start-up cost outweighs the work
+inline int solverThreadCount(size_t n, int numThreads) {
+    const size_t MIN_ROWS_PER_THREAD = 32768;
+    if (numThreads <= 0) {
+        numThreads = defaultThreadCount();
+    }
+    return (int)std::max<size_t>(1, std::min<size_t>(numThreads, n / MIN_ROWS_PER_THREAD));
+}
+
+// Split [0, n) into numParts contiguous ranges and run body(part, begin, end)
+// on each, one part per thread
+template <typename Body>
+void forEachRange(size_t n, int numParts, Body body) {
+    parallelForBlocks(numParts, 1, numParts, [&](size_t begin, size_t end, int) {
+        for (size_t part = begin; part < end; part++) {
+            body(part, n * part / numParts, n * (part + 1) / numParts);
+        }
+    });
+}
+
+// forEachRange where body(begin, end, sums) accumulates K sums over its range;
+// the partial sums of the parts are added in order
+template <int K, typename Body>
+std::array<double, K> parallelReduce(size_t n, int numParts, Body body) {
+    std::vector<std::array<double, K>> partial(numParts, std::array<double, K>{});
+    forEachRange(n, numParts, [&](size_t part, size_t begin, size_t end) {
+        body(begin, end, partial[part]);
+    });
+    
+    std::array<double, K> total{};
+    for (int part = 0; part < numParts; part++) {
+        for (int k = 0; k < K; k++) {
+            total[k] += partial[part][k];
+        }
+    }
+    return total;
+}
+
+// SpMV fused with the loop that consumes it: computes (A x)_i row by row and
+// passes it to rowOp(i, value, sums), which stores it and accumulates K sums
+template <int K, typename RowOp>
+std::array<double, K> multiplyReduce(const CSRMatrix& a, const double* x, int numThreads, RowOp rowOp) {
+    const std::vector<int>& rowPtr = a.getRowPointers();
+    const std::vector<int>& colIdx = a.getColumnIndices();
+    const std::vector<double>& values = a.getValues();
+    std::vector<int> bounds = a.balancedRowRanges(numThreads);
+    
+    std::vector<std::array<double, K>> partial(numThreads, std::array<double, K>{});
+    parallelForBlocks(numThreads, 1, numThreads, [&](size_t begin, size_t end, int) {
+        for (size_t part = begin; part < end; part++) {
+            for (int i = bounds[part]; i < bounds[part + 1]; i++) {
+                int start = rowPtr[i];
+                double value = sparseRowDot(colIdx.data() + start, values.data() + start,
+                                            (size_t)(rowPtr[i + 1] - start), x);
+                rowOp(i, value, partial[part]);
+            }
+        }
+    });
+    
+    std::array<double, K> total{};
+    for (int part = 0; part < numThreads; part++) {
+        for (int k = 0; k < K; k++) {
+            total[k] += partial[part][k];
+        }
+    }
+    return total;
+}
+
+// Relative residual ||b - A x|| / ||b|| (0 when b = 0 and A x = 0)
+inline double relativeResidual(const CSRMatrix& a, const std::vector<double>& b,
+                               const std::vector<double>& x, int numThreads = 0) {
+    int threads = solverThreadCount(b.size(), numThreads);
+    double bb = parallelReduce<1>(b.size(), threads, [&](size_t begin, size_t end, std::array<double, 1>& acc) {
+        for (size_t i = begin; i < end; i++) acc[0] += b[i] * b[i];
+    })[0];
+    double rr = multiplyReduce<1>(a, x.data(), threads, [&](int i, double ax, std::array<double, 1>& acc) {
+        acc[0] += (b[i] - ax) * (b[i] - ax);
+    })[0];
+    return bb > 0.0 ? std::sqrt(rr / bb) : std::sqrt(rr);
+}
+
+// No preconditioning: z = r
+class IdentityPreconditioner {
+private:
+    size_t n;
+    
+public:
+    explicit IdentityPreconditioner(const CSRMatrix& a) : n(a.getDimensions().first) {}
+    
+    // z = r, returning r . z
+    double apply(const double* r, double* z, int numThreads) const {
+        return parallelReduce<1>(n, numThreads, [&](size_t begin, size_t end, std::array<double, 1>& acc) {
+            for (size_t i = begin; i < end; i++) {
+                z[i] = r[i];
+                acc[0] += r[i] * r[i];
+            }
+        })[0];
+    }
+};
+
+// Jacobi (diagonal) preconditioner: z = D^-1 r
+class JacobiPreconditioner {
+private:
+    std::vector<double> inverseDiagonal;
+    
+public:
+    explicit JacobiPreconditioner(const CSRMatrix& a) {
+        int n = a.getDimensions().first;
+        inverseDiagonal.resize(n);
+        for (int i = 0; i < n; i++) {
+            double diagonal = a.get(i, i);
+            if (diagonal == 0.0) {
+                throw std::runtime_error("Jacobi preconditioner needs a non-zero diagonal");
+            }
+            inverseDiagonal[i] = 1.0 / diagonal;
+        }
+    }
+    
+    // z = D^-1 r, returning r . z
+    double apply(const double* r, double* z, int numThreads) const {
+        return parallelReduce<1>(inverseDiagonal.size(), numThreads,
+                                 [&](size_t begin, size_t end, std::array<double, 1>& acc) {
+            for (size_t i = begin; i < end; i++) {
+                z[i] = r[i] * inverseDiagonal[i];
+                acc[0] += r[i] * z[i];
+            }
+        })[0];
+    }
+};
+
+// Incomplete LU factorization with zero fill-in: L (unit lower) and U share the
+// sparsity pattern of A. The triangular solves are inherently sequential, so
+// apply() runs on one thread whatever numThreads is.
+class ILU0Preconditioner {
+private:
+    int n;
+    std::vector<int> rowPtr;
+    std::vector<int> colIdx;
+    std::vector<double> factors;         // L below the diagonal, U on and above it
+    std::vector<int> diagonalPos;        // Position of (i, i) in colIdx / factors
+    std::vector<double> inverseDiagonal; // 1 / U(i, i)
+    
+public:
+    explicit ILU0Preconditioner(const CSRMatrix& a)
+        : n(a.getDimensions().first), rowPtr(a.getRowPointers()), colIdx(a.getColumnIndices()),
+          factors(a.getValues()), diagonalPos(n), inverseDiagonal(n) {
+        if (a.getDimensions().second != n) {
+            throw std::invalid_argument("ILU(0) needs a square matrix");
+        }
+        for (int i = 0; i < n; i++) {
+            auto first = colIdx.begin() + rowPtr[i];
+            auto last = colIdx.begin() + rowPtr[i + 1];
+            auto diagonal = std::lower_bound(first, last, i);
+            if (diagonal == last || *diagonal != i) {
+                throw std::runtime_error("ILU(0) needs every diagonal entry to be stored");
+            }
+            diagonalPos[i] = (int)(diagonal - colIdx.begin());
+        }
+        
+        // Row-by-row (IKJ) elimination restricted to the pattern of A; position maps
+        // the columns of row i to their slots while the row is being eliminated
+        std::vector<int> position(n, -1);
+        for (int i = 0; i < n; i++) {
+            for (int jj = rowPtr[i]; jj < rowPtr[i + 1]; jj++) {
+                position[colIdx[jj]] = jj;
+            }
+            for (int kk = rowPtr[i]; kk < diagonalPos[i]; kk++) {
+                int k = colIdx[kk];
+                factors[kk] *= inverseDiagonal[k];
+                for (int jj = diagonalPos[k] + 1; jj < rowPtr[k + 1]; jj++) {
+                    int p = position[colIdx[jj]];
+                    if (p >= 0) {
+                        factors[p] -= factors[kk] * factors[jj];
+                    }
+                }
+            }
+            
+            double pivot = factors[diagonalPos[i]];
+            if (pivot == 0.0) {
+                throw std::runtime_error("Zero pivot in ILU(0) factorization");
+            }
+            inverseDiagonal[i] = 1.0 / pivot;
+            for (int jj = rowPtr[i]; jj < rowPtr[i + 1]; jj++) {
+                position[colIdx[jj]] = -1;
+            }
+        }
+    }
+    
+    // z = U^-1 L^-1 r, returning r . z (accumulated during the backward sweep)
+    double apply(const double* r, double* z, int) const {
+        for (int i = 0; i < n; i++) {
+            double sum = r[i];
+            for (int kk = rowPtr[i]; kk < diagonalPos[i]; kk++) {
+                sum -= factors[kk] * z[colIdx[kk]];
+            }
+            z[i] = sum;
+        }
+        
+        double rz = 0.0;
+        for (int i = n - 1; i >= 0; i--) {
+            double sum = z[i];
+            for (int jj = diagonalPos[i] + 1; jj < rowPtr[i + 1]; jj++) {
+                sum -= factors[jj] * z[colIdx[jj]];
+            }
+            z[i] = sum * inverseDiagonal[i];
+            rz += r[i] * z[i];
+        }
+        return rz;
+    }
+};
+
+// Shared argument checks; an empty x becomes the zero initial guess
+inline void checkSolverArguments(const CSRMatrix& a, const std::vector<double>& b, std::vector<double>& x) {
+    if (a.getDimensions().first != a.getDimensions().second) {
+        throw std::invalid_argument("Solver needs a square matrix");
+    }
+    size_t n = a.getDimensions().first;
+    if (b.size() != n) {
+        throw std::invalid_argument("Right-hand side length must match matrix rows");
+    }
+    if (x.empty()) {
+        x.assign(n, 0.0);
+    } else if (x.size() != n) {
+        throw std::invalid_argument("Initial guess length must match matrix columns");
+    }
+}
+
+// Preconditioned conjugate gradient for symmetric positive definite A. x holds
+// the initial guess (empty for zero) and receives the solution; iteration stops
+// once ||r|| <= tolerance * ||b||. The preconditioner must be symmetric positive
+// definite too (Identity, Jacobi, or ILU(0) of a symmetric A).
+template <typename Preconditioner>
+SolverResult conjugateGradient(const CSRMatrix& a, const std::vector<double>& b, std::vector<double>& x,
+                               const Preconditioner& m, double tolerance = 1e-8,
+                               int maxIterations = 1000, int numThreads = 0) {
+    checkSolverArguments(a, b, x);
+    size_t n = b.size();
+    int threads = solverThreadCount(n, numThreads);
+    std::vector<double> r(n), z(n), p(n), q(n);
+    
+    double bNorm = std::sqrt(parallelReduce<1>(n, threads, [&](size_t begin, size_t end, std::array<double, 1>& acc) {
+        for (size_t i = begin; i < end; i++) acc[0] += b[i] * b[i];
+    })[0]);
+    if (bNorm == 0.0) {
+        std::fill(x.begin(), x.end(), 0.0);
+        return {true, 0, 0.0};
+    }
+    double threshold = tolerance * bNorm;
+    
+    // r = b - A x
+    double rr = multiplyReduce<1>(a, x.data(), threads, [&](int i, double ax, std::array<double, 1>& acc) {
+        r[i] = b[i] - ax;
+        acc[0] += r[i] * r[i];
+    })[0];
+    
+    int iteration = 0;
+    bool converged = std::sqrt(rr) <= threshold;
+    if (!converged) {
+        double rz = m.apply(r.data(), z.data(), threads);
+        p = z;
+        
+        while (iteration < maxIterations) {
+            iteration++;
+            
+            // q = A p fused with p . q
+            double pq = multiplyReduce<1>(a, p.data(), threads, [&](int i, double ap, std::array<double, 1>& acc) {
+                q[i] = ap;
+                acc[0] += p[i] * ap;
+            })[0];
+            if (!(pq > 0.0)) {
+                break;  // A (or the preconditioner) is not positive definite
+            }
+            double alpha = rz / pq;
+            
+            // x += alpha p and r -= alpha q fused with r . r
+            rr = parallelReduce<1>(n, threads, [&](size_t begin, size_t end, std::array<double, 1>& acc) {
+                for (size_t i = begin; i < end; i++) {
+                    x[i] += alpha * p[i];
+                    r[i] -= alpha * q[i];
+                    acc[0] += r[i] * r[i];
+                }
+            })[0];
+            if (std::sqrt(rr) <= threshold) {
+                converged = true;
+                break;
+            }
+            
+            double rzNext = m.apply(r.data(), z.data(), threads);
+            double beta = rzNext / rz;
+            rz = rzNext;
+            forEachRange(n, threads, [&](size_t, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    p[i] = z[i] + beta * p[i];
+                }
+            });
+        }
+    }
+    
+    return {converged, iteration, relativeResidual(a, b, x, threads)};
+}
+
+// Right-preconditioned BiCGSTAB for general square A; arguments and stopping
+// rule as for conjugateGradient. Returns converged = false on breakdown.
+template <typename Preconditioner>
+SolverResult biCGStab(const CSRMatrix& a, const std::vector<double>& b, std::vector<double>& x,
+                      const Preconditioner& m, double tolerance = 1e-8,
+                      int maxIterations = 1000, int numThreads = 0) {
+    checkSolverArguments(a, b, x);
+    size_t n = b.size();
+    int threads = solverThreadCount(n, numThreads);
+    std::vector<double> r(n), rHat(n), p(n, 0.0), v(n, 0.0), pHat(n), s(n), sHat(n), t(n);
+    
+    double bNorm = std::sqrt(parallelReduce<1>(n, threads, [&](size_t begin, size_t end, std::array<double, 1>& acc) {
+        for (size_t i = begin; i < end; i++) acc[0] += b[i] * b[i];
+    })[0]);
+    if (bNorm == 0.0) {
+        std::fill(x.begin(), x.end(), 0.0);
+        return {true, 0, 0.0};
+    }
+    double threshold = tolerance * bNorm;
+    
+    // r = b - A x, with the shadow residual rHat = r
+    double rr = multiplyReduce<1>(a, x.data(), threads, [&](int i, double ax, std::array<double, 1>& acc) {
+        r[i] = b[i] - ax;
+        rHat[i] = r[i];
+        acc[0] += r[i] * r[i];
+    })[0];
+    
+    int iteration = 0;
+    bool converged = std::sqrt(rr) <= threshold;
+    double rho = 1.0, alpha = 1.0, omega = 1.0;
+    double rhoNext = rr;
+    
+    while (!converged && iteration < maxIterations) {
+        iteration++;
+        if (rhoNext == 0.0 || omega == 0.0) {
+            break;
+        }
+        double beta = (rhoNext / rho) * (alpha / omega);
+        rho = rhoNext;
+        
+        forEachRange(n, threads, [&](size_t, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                p[i] = r[i] + beta * (p[i] - omega * v[i]);
+            }
+        });
+        m.apply(p.data(), pHat.data(), threads);
+        
+        // v = A pHat fused with rHat . v
+        double rHatV = multiplyReduce<1>(a, pHat.data(), threads, [&](int i, double ap, std::array<double, 1>& acc) {
+            v[i] = ap;
+            acc[0] += rHat[i] * ap;
+        })[0];
+        if (rHatV == 0.0) {
+            break;
+        }
+        alpha = rho / rHatV;
+        
+        // s = r - alpha v fused with s . s
+        double ss = parallelReduce<1>(n, threads, [&](size_t begin, size_t end, std::array<double, 1>& acc) {
+            for (size_t i = begin; i < end; i++) {
+                s[i] = r[i] - alpha * v[i];
+                acc[0] += s[i] * s[i];
+            }
+        })[0];
+        if (std::sqrt(ss) <= threshold) {
+            forEachRange(n, threads, [&](size_t, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    x[i] += alpha * pHat[i];
+                }
+            });
+            converged = true;
+            break;
+        }
+        m.apply(s.data(), sHat.data(), threads);
+        
+        // t = A sHat fused with t . t and t . s
+        std::array<double, 2> tDots = multiplyReduce<2>(a, sHat.data(), threads,
+                                                   [&](int i, double as, std::array<double, 2>& acc) {
+            t[i] = as;
+            acc[0] += as * as;
+            acc[1] += as * s[i];
+        });
+        if (tDots[0] == 0.0) {
+            break;
+        }
+        omega = tDots[1] / tDots[0];
+        
+        // x += alpha pHat + omega sHat and r = s - omega t fused with r . r and rHat . r
+        std::array<double, 2> rDots = parallelReduce<2>(n, threads, [&](size_t begin, size_t end, std::array<double, 2>& acc) {
+            for (size_t i = begin; i < end; i++) {
+                x[i] += alpha * pHat[i] + omega * sHat[i];
+                r[i] = s[i] - omega * t[i];
+                acc[0] += r[i] * r[i];
+                acc[1] += rHat[i] * r[i];
+            }
+        });
+        rhoNext = rDots[1];
+        converged = std::sqrt(rDots[0]) <= threshold;
+    }
+    
+    return {converged, iteration, relativeResidual(a, b, x, threads)};
+}
+
+#endif // SPARSE_SOLVERS_H
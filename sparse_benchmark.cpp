@@ -0,0 +1,422 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <map>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <malloc.h>
+#include "linkedList.h"
+#include "arrayImplementation.h"
+using namespace std;
+
+// Allocation tracking: the global allocation functions are replaced so every
+// heap block (including the aligned SparseMatrixArray storage) is counted with
+// its real usable size
+static atomic<long long> allocationCount(0);
+static atomic<long long> liveBytes(0);
+static atomic<long long> peakBytes(0);
+
+static void* recordAllocation(void* p) {
+    if (p == nullptr) {
+        throw bad_alloc();
+    }
+    allocationCount++;
+    long long live = liveBytes += (long long)malloc_usable_size(p);
+    long long peak = peakBytes.load();
+    while (live > peak && !peakBytes.compare_exchange_weak(peak, live)) {
+    }
+    return p;
+}
+
+static void recordFree(void* p) {
+    if (p != nullptr) {
+        liveBytes -= (long long)malloc_usable_size(p);
+        free(p);
+    }
+}
+
+static void* allocateAligned(size_t size, align_val_t alignment) {
+    size_t align = max((size_t)alignment, sizeof(void*));
+    return recordAllocation(aligned_alloc(align, (max(size, (size_t)1) + align - 1) & ~(align - 1)));
+}
+
+void* operator new(size_t size) { return recordAllocation(malloc(max(size, (size_t)1))); }
+void* operator new[](size_t size) { return recordAllocation(malloc(max(size, (size_t)1))); }
+void* operator new(size_t size, align_val_t alignment) { return allocateAligned(size, alignment); }
+void* operator new[](size_t size, align_val_t alignment) { return allocateAligned(size, alignment); }
+void operator delete(void* p) noexcept { recordFree(p); }
+void operator delete[](void* p) noexcept { recordFree(p); }
+void operator delete(void* p, size_t) noexcept { recordFree(p); }
+void operator delete[](void* p, size_t) noexcept { recordFree(p); }
+void operator delete(void* p, align_val_t) noexcept { recordFree(p); }
+void operator delete[](void* p, align_val_t) noexcept { recordFree(p); }
+void operator delete(void* p, size_t, align_val_t) noexcept { recordFree(p); }
+void operator delete[](void* p, size_t, align_val_t) noexcept { recordFree(p); }
+
+// Result of one timed operation
+struct Measurement {
+    double seconds;
+    long long allocations;
+    long long bytes;        // Bytes retained (build) or peak extra bytes (other operations)
+    long long resultNnz;    // Non-zeros of the result, to cross-check backends
+    bool skipped;
+};
+
+// Time f() and count its allocations; retained = true reports the bytes still
+// live afterwards (the footprint of what f built) instead of the peak
+template <typename F>
+Measurement measure(F f, bool retained) {
+    long long liveBefore = liveBytes.load();
+    long long allocationsBefore = allocationCount.load();
+    peakBytes = liveBefore;
+
+    auto startTime = chrono::steady_clock::now();
+    long long resultNnz = f();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
+    Measurement m;
+    m.seconds = seconds;
+    m.allocations = allocationCount.load() - allocationsBefore;
+    m.bytes = (retained ? liveBytes.load() : peakBytes.load()) - liveBefore;
+    m.resultNnz = resultNnz;
+    m.skipped = false;
+    return m;
+}
+
+Measurement skippedMeasurement() {
+    return {0.0, 0, 0, 0, true};
+}
+
+// Unique random positions spread over the whole matrix, in shuffled order
+vector<Triplet> randomTriplets(int n, int nnzPerRow, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_int_distribution<int> pickCol(0, n - 1);
+    uniform_real_distribution<double> pickValue(0.5, 1.5);
+
+    vector<Triplet> triplets;
+    triplets.reserve((size_t)n * nnzPerRow);
+    for (int i = 0; i < n; i++) {
+        for (int k = 0; k < nnzPerRow; k++) {
+            triplets.push_back({i, pickCol(rng), pickValue(rng)});
+        }
+    }
+    radixSortTriplets(triplets);
+    triplets.erase(unique(triplets.begin(), triplets.end(), [](const Triplet& a, const Triplet& b) {
+        return a.row == b.row && a.col == b.col;
+    }), triplets.end());
+    shuffle(triplets.begin(), triplets.end(), rng);
+    return triplets;
+}
+
+// Unique random positions within nnzPerRow columns of the diagonal, in shuffled order
+vector<Triplet> bandedTriplets(int n, int nnzPerRow, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_real_distribution<double> pickValue(0.5, 1.5);
+    int halfBand = nnzPerRow;
+
+    vector<Triplet> triplets;
+    triplets.reserve((size_t)n * nnzPerRow);
+    for (int i = 0; i < n; i++) {
+        int lo = max(0, i - halfBand);
+        int hi = min(n - 1, i + halfBand);
+        uniform_int_distribution<int> pickCol(lo, hi);
+        for (int k = 0; k < nnzPerRow; k++) {
+            triplets.push_back({i, pickCol(rng), pickValue(rng)});
+        }
+    }
+    radixSortTriplets(triplets);
+    triplets.erase(unique(triplets.begin(), triplets.end(), [](const Triplet& a, const Triplet& b) {
+        return a.row == b.row && a.col == b.col;
+    }), triplets.end());
+    shuffle(triplets.begin(), triplets.end(), rng);
+    return triplets;
+}
+
+struct BenchmarkOptions {
+    vector<int> sizes = {1000, 10000, 100000};
+    vector<int> densities = {4, 16};
+    int lookups = 100000;
+    long long maxInsertShift = 2000000000LL; // Skip COO inserts above this many moved elements
+    long long maxProductWork = 20000000LL;   // Skip multiplies above this many partial products
+    string csvFile;
+};
+
+struct ResultRow {
+    string pattern;
+    int n;
+    int nnzPerRow;
+    long long nnz;
+    string backend;
+    string operation;
+    Measurement measurement;
+    long long estimateBytes;  // getMemoryUsage() of the built structure, -1 if not applicable
+};
+
+void runCase(const string& pattern, int n, int nnzPerRow, const BenchmarkOptions& options,
+             vector<ResultRow>& results) {
+    vector<Triplet> tripletsA = pattern == "banded" ? bandedTriplets(n, nnzPerRow, 1)
+                                                    : randomTriplets(n, nnzPerRow, 1);
+    vector<Triplet> tripletsB = pattern == "banded" ? bandedTriplets(n, nnzPerRow, 2)
+                                                    : randomTriplets(n, nnzPerRow, 2);
+    long long nnz = tripletsA.size();
+
+    mt19937 rng(3);
+    uniform_int_distribution<int> pick(0, n - 1);
+    vector<pair<int, int>> lookups(options.lookups);
+    for (auto& lookup : lookups) {
+        lookup = {pick(rng), pick(rng)};
+    }
+    vector<double> x(n, 1.0), y(n, 0.0);
+
+    // Partial products of A * B (each A(i, k) meets row k of B)
+    long long productWork = (long long)((double)nnz * tripletsB.size() / n);
+    bool doMultiply = productWork <= options.maxProductWork;
+
+    auto record = [&](const string& backend, const string& operation, Measurement m,
+                      long long estimate) {
+        results.push_back({pattern, n, nnzPerRow, nnz, backend, operation, m, estimate});
+    };
+
+    // Linked list (orthogonal list with node pool)
+    {
+        unique_ptr<SparseMatrix> a;
+        SparseMatrix b(n, n);
+        for (const Triplet& t : tripletsB) b.insert(t.row, t.col, t.value);
+
+        Measurement m = measure([&]() {
+            a = make_unique<SparseMatrix>(n, n);
+            for (const Triplet& t : tripletsA) a->insert(t.row, t.col, t.value);
+            return (long long)a->getNonZeroCount();
+        }, true);
+        record("linked-list", "insert", m, (long long)a->getMemoryUsage());
+
+        record("linked-list", "get", measure([&]() {
+            long long found = 0;
+            for (const auto& lookup : lookups) found += a->get(lookup.first, lookup.second) != 0.0;
+            return found;
+        }, false), -1);
+        record("linked-list", "add", measure([&]() {
+            return (long long)a->add(b).getNonZeroCount();
+        }, false), -1);
+        record("linked-list", "chain", measure([&]() {
+            return (long long)a->add(b).add(a->transpose()).getNonZeroCount();
+        }, false), -1);
+        record("linked-list", "chain-lazy", measure([&]() {
+            return (long long)SparseMatrix(*a + b + transpose(*a)).getNonZeroCount();
+        }, false), -1);
+        record("linked-list", "multiply", doMultiply ? measure([&]() {
+            return (long long)a->multiply(b).getNonZeroCount();
+        }, false) : skippedMeasurement(), -1);
+        record("linked-list", "transpose", measure([&]() {
+            return (long long)a->transpose().getNonZeroCount();
+        }, false), -1);
+        record("linked-list", "spmv", measure([&]() {
+            a->multiply(x.data(), y.data());
+            return (long long)n;
+        }, false), -1);
+    }
+
+    // Sorted COO arrays
+    {
+        unique_ptr<SparseMatrixArray> a;
+        SparseMatrixArray b = SparseMatrixArray::fromTriplets(n, n, tripletsB);
+
+        Measurement m = measure([&]() {
+            a = make_unique<SparseMatrixArray>(SparseMatrixArray::fromTriplets(n, n, tripletsA));
+            return (long long)a->getNonZeroCount();
+        }, true);
+        record("coo-array", "build", m, a->getMemoryUsage());
+
+        // Random-order inserts shift about nnz / 2 elements each
+        bool doInsert = nnz * nnz / 2 <= options.maxInsertShift;
+        record("coo-array", "insert", doInsert ? measure([&]() {
+            SparseMatrixArray built(n, n);
+            for (const Triplet& t : tripletsA) built.insert(t.row, t.col, t.value);
+            return (long long)built.getNonZeroCount();
+        }, false) : skippedMeasurement(), -1);
+
+        record("coo-array", "get", measure([&]() {
+            long long found = 0;
+            for (const auto& lookup : lookups) found += a->get(lookup.first, lookup.second) != 0.0;
+            return found;
+        }, false), -1);
+        record("coo-array", "add", measure([&]() {
+            return (long long)a->add(b).getNonZeroCount();
+        }, false), -1);
+        record("coo-array", "chain", measure([&]() {
+            return (long long)a->add(b).add(a->transpose()).getNonZeroCount();
+        }, false), -1);
+        record("coo-array", "chain-lazy", measure([&]() {
+            return (long long)SparseMatrixArray(*a + b + transpose(*a)).getNonZeroCount();
+        }, false), -1);
+        record("coo-array", "multiply", doMultiply ? measure([&]() {
+            return (long long)a->multiply(b).getNonZeroCount();
+        }, false) : skippedMeasurement(), -1);
+        record("coo-array", "transpose", measure([&]() {
+            return (long long)a->transpose().getNonZeroCount();
+        }, false), -1);
+        record("coo-array", "spmv", measure([&]() {
+            a->multiply(x.data(), y.data());
+            return (long long)n;
+        }, false), -1);
+    }
+
+    // CSR (immutable: built in bulk, no insert or add)
+    {
+        unique_ptr<CSRMatrix> a;
+        CSRMatrix b = SparseMatrixArray::fromTriplets(n, n, tripletsB).toCSR();
+
+        Measurement m = measure([&]() {
+            a = make_unique<CSRMatrix>(SparseMatrixArray::fromTriplets(n, n, tripletsA).toCSR());
+            return (long long)a->getNonZeroCount();
+        }, true);
+        record("csr", "build", m, (long long)a->getMemoryUsage());
+
+        record("csr", "get", measure([&]() {
+            long long found = 0;
+            for (const auto& lookup : lookups) found += a->get(lookup.first, lookup.second) != 0.0;
+            return found;
+        }, false), -1);
+        record("csr", "multiply", doMultiply ? measure([&]() {
+            return (long long)a->multiply(b).getNonZeroCount();
+        }, false) : skippedMeasurement(), -1);
+        record("csr", "transpose", measure([&]() {
+            return (long long)a->transpose().getNonZeroCount();
+        }, false), -1);
+        record("csr", "spmv", measure([&]() {
+            a->multiply(x.data(), y.data());
+            return (long long)n;
+        }, false), -1);
+    }
+}
+
+string formatBytes(long long bytes) {
+    ostringstream out;
+    out << fixed << setprecision(1);
+    if (bytes >= (1LL << 20)) {
+        out << bytes / (double)(1 << 20) << " MiB";
+    } else if (bytes >= (1LL << 10)) {
+        out << bytes / 1024.0 << " KiB";
+    } else {
+        out << bytes << " B";
+    }
+    return out.str();
+}
+
+void printResults(const vector<ResultRow>& results) {
+    string lastCase;
+    map<string, long long> expectedNnz;
+
+    for (const ResultRow& row : results) {
+        string caseName = row.pattern + " n=" + to_string(row.n) + " nnz/row=" +
+                          to_string(row.nnzPerRow);
+        if (caseName != lastCase) {
+            cout << "\n" << caseName << " (" << row.nnz << " non-zeros)" << endl;
+            cout << left << setw(14) << "Backend" << setw(11) << "Operation" << right
+                 << setw(13) << "Time (ms)" << setw(13) << "Allocations"
+                 << setw(14) << "Bytes" << setw(14) << "Estimate" << endl;
+            lastCase = caseName;
+            expectedNnz.clear();
+        }
+
+        cout << left << setw(14) << row.backend << setw(11) << row.operation << right;
+        if (row.measurement.skipped) {
+            cout << setw(13) << "skipped" << endl;
+            continue;
+        }
+        cout << setw(13) << fixed << setprecision(3) << row.measurement.seconds * 1000.0
+             << setw(13) << row.measurement.allocations
+             << setw(14) << formatBytes(row.measurement.bytes)
+             << setw(14) << (row.estimateBytes >= 0 ? formatBytes(row.estimateBytes) : "-");
+
+        // Every backend must agree on the size of each result
+        string key = row.operation == "insert" ? "build" 
+                   : row.operation == "chain-lazy" ? "chain" : row.operation;
+        auto it = expectedNnz.find(key);
+        if (it == expectedNnz.end()) {
+            expectedNnz[key] = row.measurement.resultNnz;
+        } else if (it->second != row.measurement.resultNnz) {
+            cout << "  MISMATCH (" << row.measurement.resultNnz << " vs " << it->second << ")";
+        }
+        cout << endl;
+    }
+}
+
+void writeCsv(const string& filename, const vector<ResultRow>& results) {
+    ofstream out(filename);
+    if (!out) {
+        throw runtime_error("Cannot create CSV file '" + filename + "'");
+    }
+    out << "pattern,n,nnz_per_row,nnz,backend,operation,seconds,allocations,bytes,estimate_bytes\n";
+    for (const ResultRow& row : results) {
+        out << row.pattern << "," << row.n << "," << row.nnzPerRow << "," << row.nnz << ","
+            << row.backend << "," << row.operation << ",";
+        if (row.measurement.skipped) {
+            out << ",,,\n";
+            continue;
+        }
+        out << setprecision(9) << row.measurement.seconds << "," << row.measurement.allocations
+            << "," << row.measurement.bytes << ",";
+        if (row.estimateBytes >= 0) out << row.estimateBytes;
+        out << "\n";
+    }
+}
+
+vector<int> parseList(const string& text) {
+    vector<int> values;
+    stringstream in(text);
+    string item;
+    while (getline(in, item, ',')) {
+        values.push_back(stoi(item));
+    }
+    return values;
+}
+
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--csv" && i + 1 < argc) {
+            options.csvFile = argv[++i];
+        } else if (arg == "--sizes" && i + 1 < argc) {
+            options.sizes = parseList(argv[++i]);
+        } else if (arg == "--densities" && i + 1 < argc) {
+            options.densities = parseList(argv[++i]);
+        } else {
+            cout << "Usage: " << argv[0] << " [--csv file] [--sizes n1,n2,...] "
+                 << "[--densities nnzPerRow1,...]" << endl;
+            return 1;
+        }
+    }
+
+    cout << "Sparse Matrix Backend Benchmark" << endl;
+    cout << "===============================" << endl;
+
+    vector<ResultRow> results;
+    try {
+        for (const string pattern : {"random", "banded"}) {
+            for (int n : options.sizes) {
+                for (int nnzPerRow : options.densities) {
+                    runCase(pattern, n, nnzPerRow, options, results);
+                }
+            }
+        }
+
+        printResults(results);
+        if (!options.csvFile.empty()) {
+            writeCsv(options.csvFile, results);
+            cout << "\nResults written to " << options.csvFile << endl;
+        }
+    } catch (const exception& e) {
+        cout << "Error: " << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
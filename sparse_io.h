@@ -0,0 +1,491 @@
+#ifndef SPARSE_IO_H
+#define SPARSE_IO_H
+
+// Matrix Market (.mtx) and binary CSR file I/O shared by the sparse matrix
+// implementations (linkedList.cpp, arrayImplementation.cpp).
+//
+// Matrix Market files are streamed through a fixed-size buffer and parsed with
+// hand-written number parsers. The binary CSR format is a small header followed
+// by the row pointer, column index and value arrays, so it can be mapped with
+// mmap and used without parsing.
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace sparse_io {
+
+// Fast number parsing
+
+// Parse an unsigned or signed decimal integer; advances p, returns false if no digits
+inline bool parseInteger(const char*& p, const char* end, long long& out) {
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+    const char* start = p;
+    long long value = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        value = value * 10 + (*p - '0');
+        p++;
+    }
+    out = negative ? -value : value;
+    return p != start;
+}
+
+// Parse a decimal floating-point number; advances p, returns false on failure.
+// Values with at most 15 significant digits and a small exponent are converted
+// exactly with one multiply or divide by a power of ten; anything else goes
+// through std::from_chars, which is also correctly rounded.
+inline bool parseReal(const char*& p, const char* end, double& out) {
+    static const double POWERS_OF_TEN[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    const char* start = p;
+
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool anyDigits = false;
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa != 0) digits++;
+        } else {
+            exponent++;
+        }
+        anyDigits = true;
+        p++;
+    }
+    if (p < end && *p == '.') {
+        p++;
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa != 0) digits++;
+                exponent--;
+            }
+            anyDigits = true;
+            p++;
+        }
+    }
+    if (!anyDigits) {
+        // inf/nan and other spellings
+        char* strtodEnd;
+        std::string token(start, std::min<size_t>(end - start, 64));
+        out = strtod(token.c_str(), &strtodEnd);
+        p = start + (strtodEnd - token.c_str());
+        return p != start;
+    }
+    if (p < end && (*p == 'e' || *p == 'E' || *p == 'd' || *p == 'D')) {
+        const char* expStart = p;
+        p++;
+        long long explicitExponent;
+        if (parseInteger(p, end, explicitExponent)) {
+            exponent += (int)std::max(-100000LL, std::min(100000LL, explicitExponent));
+        } else {
+            p = expStart;
+        }
+    }
+
+    if (digits <= 15 && exponent >= -22 && exponent <= 22) {
+        double value = (double)mantissa;
+        value = exponent >= 0 ? value * POWERS_OF_TEN[exponent] : value / POWERS_OF_TEN[-exponent];
+        out = negative ? -value : value;
+        return true;
+    }
+
+    // Slow path: normalise into a stack buffer (no '+' sign, Fortran 'D' exponent
+    // as 'e') for from_chars; longer tokens (e.g. long mantissas) get a heap
+    // buffer rather than being cut short
+    char stackToken[64];
+    std::string longToken;
+    char* token = stackToken;
+    if ((size_t)(p - start) > sizeof(stackToken)) {
+        longToken.resize(p - start);
+        token = &longToken[0];
+    }
+    size_t length = 0;
+    for (const char* q = start; q < p; q++) {
+        if (q == start && *q == '+') continue;
+        token[length++] = (*q == 'd' || *q == 'D') ? 'e' : *q;
+    }
+    std::from_chars_result result = std::from_chars(token, token + length, out);
+    if (result.ec == std::errc::result_out_of_range) {
+        out = strtod(std::string(token, length).c_str(), nullptr); // +-inf or denormal/zero
+    }
+    return result.ptr != token;
+}
+
+// Matrix Market reading
+
+struct MatrixMarketHeader {
+    int rows;
+    int cols;
+    long long entries;   // Entries listed in the file (before symmetric expansion)
+    bool pattern;        // No values; every entry is 1.0
+    bool symmetric;      // Only the lower triangle is stored
+    bool skewSymmetric;  // Lower triangle stored, A(j, i) = -A(i, j)
+};
+
+// Stream a coordinate Matrix Market file. onSize(header) is called once before
+// any entry; onEntry(row, col, value) is called with 0-based indices for every
+// stored entry, and again with (col, row) for the mirrored half of symmetric
+// and skew-symmetric matrices. Only a fixed-size read buffer is held in memory.
+template <typename OnSize, typename OnEntry>
+MatrixMarketHeader readMatrixMarket(const std::string& filename, OnSize onSize, OnEntry onEntry) {
+    std::unique_ptr<FILE, int (*)(FILE*)> file(fopen(filename.c_str(), "rb"), fclose);
+    if (file == nullptr) {
+        throw std::runtime_error("Cannot open Matrix Market file '" + filename + "'");
+    }
+
+    const size_t BUFFER_SIZE = 1 << 20;
+    std::vector<char> buffer(BUFFER_SIZE);
+    size_t begin = 0;
+    size_t filled = 0;
+    bool eof = false;
+    long long lineNumber = 0;
+
+    // Return the next line as [lineBegin, lineEnd) inside the buffer, refilling
+    // (and moving a partial line to the front) as needed
+    auto nextLine = [&](const char*& lineBegin, const char*& lineEnd) -> bool {
+        while (true) {
+            char* newline = static_cast<char*>(memchr(buffer.data() + begin, '\n', filled - begin));
+            if (newline != nullptr) {
+                lineBegin = buffer.data() + begin;
+                lineEnd = newline;
+                begin = newline - buffer.data() + 1;
+                lineNumber++;
+                return true;
+            }
+            if (eof) {
+                if (begin == filled) return false;
+                lineBegin = buffer.data() + begin;
+                lineEnd = buffer.data() + filled;
+                begin = filled;
+                lineNumber++;
+                return true;
+            }
+            size_t remaining = filled - begin;
+            if (remaining == buffer.size()) {
+                buffer.resize(buffer.size() * 2); // Pathologically long line
+            }
+            memmove(buffer.data(), buffer.data() + begin, remaining);
+            begin = 0;
+            filled = remaining;
+            size_t got = fread(buffer.data() + filled, 1, buffer.size() - filled, file.get());
+            filled += got;
+            if (got == 0) eof = true;
+        }
+    };
+
+    auto fail = [&](const std::string& message) {
+        throw std::runtime_error("Matrix Market file '" + filename + "', line " +
+                                 std::to_string(lineNumber) + ": " + message);
+    };
+
+    const char* line;
+    const char* lineEnd;
+
+    // Banner: %%MatrixMarket matrix coordinate <field> <symmetry>
+    if (!nextLine(line, lineEnd)) fail("empty file");
+    std::string banner(line, lineEnd);
+    for (char& ch : banner) ch = (char)tolower((unsigned char)ch);
+    if (banner.compare(0, 14, "%%matrixmarket") != 0) fail("missing %%MatrixMarket banner");
+    if (banner.find("coordinate") == std::string::npos) fail("only coordinate format is supported");
+    if (banner.find("complex") != std::string::npos) fail("complex matrices are not supported");
+
+    MatrixMarketHeader header;
+    header.pattern = banner.find("pattern") != std::string::npos;
+    header.symmetric = banner.find(" symmetric") != std::string::npos;
+    header.skewSymmetric = banner.find("skew-symmetric") != std::string::npos;
+    if (banner.find("hermitian") != std::string::npos) header.symmetric = true;
+
+    // Skip comments, then read the size line
+    do {
+        if (!nextLine(line, lineEnd)) fail("missing size line");
+    } while (line == lineEnd || *line == '%' || *line == '\r');
+
+    long long rows, cols, entries;
+    const char* p = line;
+    if (!parseInteger(p, lineEnd, rows) || !parseInteger(p, lineEnd, cols) ||
+        !parseInteger(p, lineEnd, entries) || rows < 0 || cols < 0 || entries < 0 ||
+        rows > INT32_MAX || cols > INT32_MAX) {
+        fail("malformed size line");
+    }
+    header.rows = (int)rows;
+    header.cols = (int)cols;
+    header.entries = entries;
+    onSize(header);
+
+    long long seen = 0;
+    while (seen < entries && nextLine(line, lineEnd)) {
+        p = line;
+        long long row, col;
+        if (!parseInteger(p, lineEnd, row)) {
+            // Blank or comment line
+            while (p < lineEnd && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+            if (p == lineEnd || *p == '%') continue;
+            fail("malformed entry");
+        }
+        if (!parseInteger(p, lineEnd, col)) fail("malformed entry");
+        double value = 1.0;
+        if (!header.pattern && !parseReal(p, lineEnd, value)) fail("malformed value");
+        if (row < 1 || row > rows || col < 1 || col > cols) fail("entry index out of range");
+
+        onEntry((int)row - 1, (int)col - 1, value);
+        if ((header.symmetric || header.skewSymmetric) && row != col) {
+            onEntry((int)col - 1, (int)row - 1, header.skewSymmetric ? -value : value);
+        }
+        seen++;
+    }
+    if (seen < entries) fail("file ends after " + std::to_string(seen) + " of " +
+                             std::to_string(entries) + " entries");
+
+    return header;
+}
+
+// Matrix Market writing
+
+// Buffered writer for "%%MatrixMarket matrix coordinate real general" files.
+// Entries are written with 1-based indices and round-trip exact values.
+class MatrixMarketWriter {
+private:
+    FILE* file;
+    std::string filename;
+    std::vector<char> buffer;
+    size_t used;
+
+    void flush() {
+        if (used > 0 && fwrite(buffer.data(), 1, used, file) != used) {
+            throw std::runtime_error("Write to '" + filename + "' failed");
+        }
+        used = 0;
+    }
+
+    // Append a number without printf; doubles use the shortest text that
+    // reads back to the same value
+    template <typename T>
+    void append(T value) {
+        std::to_chars_result result = std::to_chars(buffer.data() + used, 
+                                                    buffer.data() + buffer.size(), value);
+        used = result.ptr - buffer.data();
+    }
+
+public:
+    MatrixMarketWriter(const std::string& name, int rows, int cols, long long entries)
+        : file(fopen(name.c_str(), "wb")), filename(name), buffer(1 << 20), used(0) {
+        if (file == nullptr) {
+            throw std::runtime_error("Cannot create Matrix Market file '" + name + "'");
+        }
+        used = snprintf(buffer.data(), buffer.size(),
+                        "%%%%MatrixMarket matrix coordinate real general\n%d %d %lld\n",
+                        rows, cols, entries);
+    }
+
+    ~MatrixMarketWriter() {
+        if (file != nullptr) {
+            fclose(file);
+        }
+    }
+
+    MatrixMarketWriter(const MatrixMarketWriter&) = delete;
+    MatrixMarketWriter& operator=(const MatrixMarketWriter&) = delete;
+
+    // Write one entry (0-based indices)
+    void write(int row, int col, double value) {
+        if (buffer.size() - used < 64) {
+            flush();
+        }
+        append(row + 1);
+        buffer[used++] = ' ';
+        append(col + 1);
+        buffer[used++] = ' ';
+        append(value);
+        buffer[used++] = '\n';
+    }
+
+    // Flush and close; errors surface here rather than in the destructor
+    void close() {
+        flush();
+        int status = fclose(file);
+        file = nullptr;
+        if (status != 0) {
+            throw std::runtime_error("Closing '" + filename + "' failed");
+        }
+    }
+};
+
+// Binary CSR format
+//
+//   offset 0   char[8]  magic "SPCSR\0\1\0"
+//   offset 8   int64    rows
+//   offset 16  int64    cols
+//   offset 24  int64    nnz
+//   offset 32  int32    rowPtr[rows + 1], padded to a multiple of 8 bytes
+//              int32    colIdx[nnz], padded to a multiple of 8 bytes
+//              double   values[nnz]
+//
+// Integers and doubles are stored in native (little-endian) byte order.
+
+static const char BINARY_CSR_MAGIC[8] = {'S', 'P', 'C', 'S', 'R', '\0', '\1', '\0'};
+static const size_t BINARY_CSR_HEADER_BYTES = 32;
+
+inline size_t paddedTo8(size_t bytes) {
+    return (bytes + 7) & ~(size_t)7;
+}
+
+// Write CSR arrays in the binary format
+inline void writeBinaryCSR(const std::string& filename, int rows, int cols,
+                           const int* rowPtr, const int* colIdx, const double* values) {
+    FILE* file = fopen(filename.c_str(), "wb");
+    if (file == nullptr) {
+        throw std::runtime_error("Cannot create binary CSR file '" + filename + "'");
+    }
+
+    int64_t nnz = rowPtr[rows];
+    int64_t dims[3] = {rows, cols, nnz};
+    const char zeros[8] = {0};
+    size_t rowPtrBytes = sizeof(int) * ((size_t)rows + 1);
+    size_t colIdxBytes = sizeof(int) * (size_t)nnz;
+
+    bool ok = fwrite(BINARY_CSR_MAGIC, 1, 8, file) == 8 &&
+              fwrite(dims, sizeof(int64_t), 3, file) == 3 &&
+              fwrite(rowPtr, 1, rowPtrBytes, file) == rowPtrBytes &&
+              fwrite(zeros, 1, paddedTo8(rowPtrBytes) - rowPtrBytes, file) == paddedTo8(rowPtrBytes) - rowPtrBytes &&
+              fwrite(colIdx, 1, colIdxBytes, file) == colIdxBytes &&
+              fwrite(zeros, 1, paddedTo8(colIdxBytes) - colIdxBytes, file) == paddedTo8(colIdxBytes) - colIdxBytes &&
+              fwrite(values, sizeof(double), (size_t)nnz, file) == (size_t)nnz;
+    ok = (fclose(file) == 0) && ok;
+    if (!ok) {
+        throw std::runtime_error("Write to '" + filename + "' failed");
+    }
+}
+
+// Read-only memory mapping of a binary CSR file; the arrays point straight into
+// the mapped pages and stay valid for the lifetime of the object. The whole
+// structure is checked on open (exact file size, row pointers non-decreasing
+// within [0, nnz], columns in range and strictly increasing in each row), so
+// readers can trust every index.
+class MappedCSRFile {
+private:
+    void* mapping;
+    size_t length;
+    int rows;
+    int cols;
+    int nnz;
+    const int* rowPtr;
+    const int* colIdx;
+    const double* values;
+
+public:
+    explicit MappedCSRFile(const std::string& filename)
+        : mapping(nullptr), length(0), rows(0), cols(0), nnz(0),
+          rowPtr(nullptr), colIdx(nullptr), values(nullptr) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open binary CSR file '" + filename + "'");
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || (size_t)info.st_size < BINARY_CSR_HEADER_BYTES) {
+            ::close(fd);
+            throw std::runtime_error("Binary CSR file '" + filename + "' is truncated");
+        }
+        length = (size_t)info.st_size;
+        mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            mapping = nullptr;
+            throw std::runtime_error("Cannot map binary CSR file '" + filename + "'");
+        }
+
+        auto reject = [&](const std::string& reason) {
+            munmap(mapping, length);
+            mapping = nullptr;
+            throw std::runtime_error("'" + filename + "' " + reason);
+        };
+
+        const char* base = static_cast<const char*>(mapping);
+        int64_t dims[3];
+        memcpy(dims, base + 8, sizeof(dims));
+        bool valid = memcmp(base, BINARY_CSR_MAGIC, 8) == 0 &&
+                     dims[0] >= 0 && dims[0] <= INT32_MAX &&
+                     dims[1] >= 0 && dims[1] <= INT32_MAX &&
+                     dims[2] >= 0 && dims[2] <= INT32_MAX;
+
+        size_t rowPtrBytes = valid ? paddedTo8(sizeof(int) * ((size_t)dims[0] + 1)) : 0;
+        size_t colIdxBytes = valid ? paddedTo8(sizeof(int) * (size_t)dims[2]) : 0;
+        size_t expected = BINARY_CSR_HEADER_BYTES + rowPtrBytes + colIdxBytes +
+                          sizeof(double) * (size_t)(valid ? dims[2] : 0);
+        if (!valid || length != expected) {
+            reject("is not a valid binary CSR file");
+        }
+
+        rows = (int)dims[0];
+        cols = (int)dims[1];
+        nnz = (int)dims[2];
+        rowPtr = reinterpret_cast<const int*>(base + BINARY_CSR_HEADER_BYTES);
+        colIdx = reinterpret_cast<const int*>(base + BINARY_CSR_HEADER_BYTES + rowPtrBytes);
+        values = reinterpret_cast<const double*>(base + BINARY_CSR_HEADER_BYTES + rowPtrBytes + colIdxBytes);
+
+        if (rowPtr[0] != 0 || rowPtr[rows] != nnz) {
+            reject("has inconsistent row pointers");
+        }
+        for (int i = 0; i < rows; i++) {
+            if (rowPtr[i + 1] < rowPtr[i] || rowPtr[i + 1] > nnz) {
+                reject("has decreasing or out-of-range row pointers");
+            }
+        }
+        for (int i = 0; i < rows; i++) {
+            for (int k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+                if (colIdx[k] < 0 || colIdx[k] >= cols || (k > rowPtr[i] && colIdx[k] <= colIdx[k - 1])) {
+                    reject("has unsorted or invalid columns");
+                }
+            }
+        }
+        madvise(mapping, length, MADV_SEQUENTIAL);
+    }
+
+    ~MappedCSRFile() {
+        if (mapping != nullptr) {
+            munmap(mapping, length);
+        }
+    }
+
+    MappedCSRFile(const MappedCSRFile&) = delete;
+    MappedCSRFile& operator=(const MappedCSRFile&) = delete;
+
+    int getRows() const { return rows; }
+    int getCols() const { return cols; }
+    int getNonZeroCount() const { return nnz; }
+    const int* getRowPointers() const { return rowPtr; }
+    const int* getColumnIndices() const { return colIdx; }
+    const double* getValues() const { return values; }
+};
+
+} // namespace sparse_io
+
+#endif // SPARSE_IO_H